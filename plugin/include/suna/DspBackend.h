@@ -0,0 +1,138 @@
+#pragma once
+
+#include "wasm_export.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace suna {
+
+/** Engine running the DSP behind WasmDSP */
+enum class DspBackendType : int {
+    WamrAot = 0,   // the MoonBit module, AOT-compiled and run by WAMR
+    Native = 1     // NativeDSP, the same engine compiled as C++
+};
+
+/** DSP exports (dsp/src/exports.mbt); every export returns one i32 */
+enum class DspExport : int {
+    InitSampler,
+    LoadSample,
+    ClearSlot,
+    PlayAll,
+    StopAll,
+    GetSlotLength,
+    ProcessBlock,
+    SetBlendX,
+    SetBlendY,
+    SetPlaybackSpeed,
+    SetGrainLength,
+    SetGrainDensity,
+    SetFreeze,
+    SetSpeedTarget,
+    SetInterpolation,
+    SetGrainJitter,
+    SetMaxOverlap,
+    SetRenderPartition,
+    SetLiveInput,
+    SetCaptureDelay,
+    SetCaptureWindow,
+    GetAllocationCount,
+    Count
+};
+
+/** Export name in the WASM module, e.g. "process_block" */
+const char* getExportName(DspExport function);
+
+/** "wamr" or "native" */
+const char* getBackendName(DspBackendType type);
+
+/** @return false if name is neither "wamr" nor "native" */
+bool parseBackendName(const std::string& name, DspBackendType& type);
+
+/** Time spent in one DSP function, from a profiling build (SUNA_WASM_PROFILING) */
+struct FunctionProfile {
+    std::string name;       // from the module's name section, else "func N"
+    double totalMs = 0.0;   // including the functions it calls
+    double selfMs = 0.0;    // excluding them
+    uint64_t calls = 0;
+};
+
+/**
+ * DspBackend - one instance of the DSP engine and its linear memory
+ *
+ * WasmDSP lays out the I/O buffers, sample slots and control region in the
+ * backend's memory and drives it only through call(), so every backend
+ * sees the same memory contents and the same sequence of calls.
+ */
+class DspBackend {
+public:
+    virtual ~DspBackend() = default;
+
+    virtual DspBackendType getType() const = 0;
+
+    /** Address 0 of linear memory (may move when the memory grows) */
+    virtual uint8_t* getMemoryBase() = 0;
+    virtual uint64_t getMemorySize() = 0;
+
+    /**
+     * Call an export with i32/f32 arguments
+     * @param result Receives the export's i32 result (may be null)
+     * @return false if the call trapped (see getException)
+     */
+    virtual bool call(DspExport function, uint32_t numArgs, wasm_val_t* args,
+                      int32_t* result = nullptr) = 0;
+
+    /** Message of the last trap, or nullptr */
+    virtual const char* getException() = 0;
+
+    /** WAMR module instance (shared sample heap), nullptr for other backends */
+    virtual wasm_module_inst_t getModuleInstance() { return nullptr; }
+
+    /**
+     * Per-function time since the instance was created
+     * @return false if the backend cannot profile (only a WAMR backend in a
+     *         SUNA_WASM_PROFILING build can)
+     */
+    virtual bool getProfile(std::vector<FunctionProfile>& functions) {
+        (void)functions;
+        return false;
+    }
+
+    /** Call stack of the last trap (profiling builds), or empty */
+    virtual std::string getCallStack() { return {}; }
+};
+
+/** Module instance of an AOT module, in an initialized WAMR runtime */
+class WamrBackend : public DspBackend {
+public:
+    /**
+     * Instantiate the module and look up every export
+     * @return nullptr (with error set) on failure
+     */
+    static std::unique_ptr<WamrBackend> create(wasm_module_t module, uint32_t stackSize,
+                                               uint32_t heapSize, std::string& error);
+    ~WamrBackend() override;
+
+    DspBackendType getType() const override { return DspBackendType::WamrAot; }
+    uint8_t* getMemoryBase() override;
+    uint64_t getMemorySize() override;
+    bool call(DspExport function, uint32_t numArgs, wasm_val_t* args,
+              int32_t* result = nullptr) override;
+    const char* getException() override;
+    wasm_module_inst_t getModuleInstance() override { return moduleInst_; }
+#if SUNA_WASM_PROFILING
+    bool getProfile(std::vector<FunctionProfile>& functions) override;
+    std::string getCallStack() override;
+#endif
+
+private:
+    WamrBackend() = default;
+
+    wasm_module_inst_t moduleInst_ = nullptr;
+    wasm_exec_env_t execEnv_ = nullptr;
+    std::array<wasm_function_inst_t, static_cast<size_t>(DspExport::Count)> functions_{};
+};
+
+} // namespace suna
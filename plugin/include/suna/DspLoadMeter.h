@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace suna {
+
+/**
+ * DspLoadMeter - processBlock time relative to the block's duration
+ *
+ * The audio thread records every block; any other thread can take a
+ * snapshot at UI rate. Recording is wait-free (the audio thread is the
+ * only writer of the counters) and a snapshot never blocks it.
+ *
+ * Load is processing time / block duration: 1.0 uses the whole deadline.
+ */
+class DspLoadMeter {
+public:
+    /** Histogram buckets: 10% of load each, the last one holds >= 100% */
+    static constexpr int BUCKET_COUNT = 11;
+
+    /** Blocks at or above this load leave little headroom for the host */
+    static constexpr float XRUN_RISK_LOAD = 0.8f;
+
+    struct Snapshot {
+        uint64_t blocks = 0;
+        std::array<uint64_t, BUCKET_COUNT> histogram{};
+        uint64_t xrunRisk = 0;     // blocks at or above XRUN_RISK_LOAD
+        uint64_t overruns = 0;     // blocks that took longer than their duration
+        float lastLoad = 0.0f;
+        float averageLoad = 0.0f;  // smoothed over roughly the last 100 blocks
+        float peakLoad = 0.0f;     // highest since the previous snapshot
+        float maxLoad = 0.0f;      // highest since reset
+    };
+
+    /** Audio thread: one processed block */
+    void record(double elapsedSeconds, double blockSeconds);
+
+    /** Any thread; starts a new peakLoad window */
+    Snapshot snapshot();
+
+    /** Clear all counters (while no block is being recorded) */
+    void reset();
+
+private:
+    // Written by the audio thread only, so plain load/store suffices
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> histogram_{};
+    std::atomic<uint64_t> blocks_{0};
+    std::atomic<uint64_t> xrunRisk_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<float> lastLoad_{0.0f};
+    std::atomic<float> averageLoad_{0.0f};
+    std::atomic<float> maxLoad_{0.0f};
+
+    // Raised by the audio thread, cleared by snapshot()
+    std::atomic<float> peakLoad_{0.0f};
+
+    static void increment(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace suna
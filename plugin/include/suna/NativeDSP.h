@@ -0,0 +1,318 @@
+#pragma once
+
+#include "suna/DspBackend.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace suna {
+
+/**
+ * NativeDSP - the MoonBit grain engine (dsp/src) ported to C++
+ *
+ * Same exports, state and arithmetic as the AOT module, operating on a
+ * linear memory of its own with the same layout (I/O buffers, slots,
+ * freeze cache, control region, capture ring), so the host side of WasmDSP
+ * is shared by both backends. Memory is accessed without bounds checks and
+ * calls are plain C++ calls: the difference to the WAMR backend is the cost
+ * of the WASM boundary and sandbox.
+ *
+ * Keep it in step with dsp/src; the backend comparison test renders the
+ * same scripts through both and checks that the outputs match.
+ */
+class NativeDSP {
+public:
+    /** Linear memory size of the MoonBit module (1024 pages) */
+    static constexpr uint32_t MEMORY_BYTES = 1024u * 65536u;
+
+    NativeDSP();
+    ~NativeDSP();
+
+    NativeDSP(const NativeDSP&) = delete;
+    NativeDSP& operator=(const NativeDSP&) = delete;
+
+    /** @return nullptr if the linear memory could not be allocated */
+    uint8_t* getMemory() { return memory_; }
+
+    // Exports (dsp/src/exports.mbt and lib.mbt)
+    int32_t initSampler(float sampleRate, int32_t poolSize);
+    int32_t loadSample(int32_t slot, int32_t dataPtr, int32_t length);
+    int32_t clearSlot(int32_t slot);
+    int32_t playAll();
+    int32_t stopAll();
+    int32_t getSlotLength(int32_t slot);
+    int32_t processBlock(int32_t statePtr, int32_t leftInPtr, int32_t rightInPtr,
+                         int32_t leftOutPtr, int32_t rightOutPtr, int32_t numSamples);
+    int32_t setBlendX(float value);
+    int32_t setBlendY(float value);
+    int32_t setPlaybackSpeed(float speed);
+    int32_t setGrainLength(int32_t length);
+    int32_t setGrainDensity(float density);
+    int32_t setFreeze(int32_t value);
+    int32_t setSpeedTarget(float target);
+    int32_t setInterpolation(int32_t mode);
+    int32_t setGrainJitter(float jitter);
+    int32_t setMaxOverlap(int32_t overlap);
+    int32_t setLiveInput(int32_t slot);
+    int32_t setCaptureDelay(int32_t samples);
+    int32_t setCaptureWindow(int32_t samples);
+    int32_t setRenderPartition(int32_t index, int32_t count);
+    int32_t getAllocationCount() const { return allocationCount_; }
+
+    static constexpr int MAX_SLOT_COUNT = 8;
+    static constexpr int MAX_GRAIN_POOL_SIZE = 2000;
+    static constexpr int SPAWN_QUEUE_CAPACITY = 256;
+    static constexpr int RAMP_SEGMENT_LENGTH = 32;
+    static constexpr int MAX_VOICES = 8;
+
+private:
+    struct Grain {
+        int32_t slot = 0;
+        int32_t startPos = 0;
+        int64_t phase = 0;      // 32.32 fixed-point position within the grain
+        int64_t endPhase = 0;
+        int32_t length = 0;
+        int32_t active = 0;
+        int32_t wait = 0;       // samples into the current segment before it starts
+        float pitch = 1.0f;
+        float amp = 1.0f;
+
+        float position() const;
+        int64_t readPosition(bool reverse) const;
+    };
+
+    struct SlotMeta {
+        int32_t dataPtr = 0;
+        int32_t length = 0;
+        float playPos = 0.0f;
+        int32_t playing = 0;
+    };
+
+    uint8_t* memory_ = nullptr;
+
+    float loadF32(int32_t ptr) const;
+    void storeF32(int32_t ptr, float value);
+    int32_t loadI32(int32_t ptr) const;
+
+    // alloc.mbt
+    int32_t allocationCount_ = 0;
+
+    // lib.mbt
+    int32_t previousSlotCount_ = 0;
+    bool grainPoolInitialized_ = false;
+    int32_t grainPoolSizeSetting_ = 100;
+
+    // grain.mbt
+    std::vector<Grain> grains_;
+    int32_t poolSize_ = 0;
+    std::array<int32_t, MAX_GRAIN_POOL_SIZE> aliveGrains_{};
+    int32_t aliveCount_ = 0;
+    std::array<int32_t, MAX_GRAIN_POOL_SIZE> freeGrains_{};
+    int32_t freeCount_ = 0;
+    int32_t grainLength_ = 4224;
+    float grainDensity_ = 0.0f;
+    int32_t maxOverlap_ = 100;
+    int32_t cloudSlotCount_ = 0;
+    int32_t nextSpawnSlot_ = 0;
+    int32_t randomSeed_ = 12345;
+
+    int32_t getMaxOverlap() const;
+    int32_t getActiveGrainCount() const;
+    int32_t randomNext();
+    int32_t randomRange(int32_t min, int32_t max);
+    float randomUnit();
+    void reserveGrains();
+    void initGrainPoolWithSize(int32_t size);
+    void stopAllGrains();
+    void respawnGrain(int32_t index);
+    void respawnSlotGrains(int32_t slot);
+    int32_t spawnGrain(int32_t slot, int32_t wait);
+    int32_t spawnPitchedGrain(int32_t slot, int32_t wait, float pitch, float amp);
+    int32_t spawnNextGrain(int32_t wait);
+    void retireGrain(int32_t alivePos);
+    void distributeGrains(int32_t activeSlotCount);
+
+    // slot.mbt
+    std::vector<SlotMeta> slots_;
+    int32_t slotCount_ = 0;
+    float sampleRate_ = 48000.0f;
+    float playbackSpeed_ = 1.0f;
+    bool freeze_ = false;
+    float targetSpeed_ = 0.0f;
+    float currentSpeed_ = 0.0f;
+    float speedRampStep_ = 0.0f;
+    float segmentSpeed_ = 0.0f;
+    float segmentSpeedStep_ = 0.0f;
+    bool speedFollowsLane_ = false;
+    float laneSpeed_ = 0.0f;
+
+    void reserveSlots();
+    void initSlots();
+    int32_t loadSampleToSlot(int32_t slot, int32_t dataPtr, int32_t length);
+    int32_t clearSlotData(int32_t slot);
+    int32_t getSlotSampleLength(int32_t slot) const;
+    int32_t getSlotDataPtr(int32_t slot) const;
+    void applyPlaybackSpeed(float speed);
+    void applyFreeze(bool value);
+    void applySpeedTarget(float target);
+    int32_t planSpeedSegment(int32_t maxLen);
+    void followSpeedSegment(float endSpeed, int32_t len);
+    void startAllSlots();
+    void stopAllSlots();
+
+    // blend.mbt
+    float blendX_ = 0.0f;
+    float blendY_ = 0.0f;
+    std::array<float, MAX_SLOT_COUNT> gains_{};
+    std::array<float, MAX_SLOT_COUNT> targetGains_{};
+    std::array<float, MAX_SLOT_COUNT> segmentGains_{};
+    std::array<float, MAX_SLOT_COUNT> segmentGainSteps_{};
+    int32_t gainCount_ = 0;
+    std::array<float, MAX_SLOT_COUNT> blendWeights_{};
+    std::array<float, MAX_SLOT_COUNT> slotPosX_{};
+    std::array<float, MAX_SLOT_COUNT> slotPosY_{};
+    int32_t geometrySlotCount_ = -1;
+    float geometryNorm_ = 1.0f;
+    float geometryEqualGain_ = 1.0f;
+    int32_t prevSlotCount_ = -1;
+
+    void updateGains();
+    void updateSlotGeometry(int32_t slotCount);
+    void computeBlendGains(float x, float y);
+    static float gainRampDecay(int32_t len);
+    static float gainRampEnd(float start, float target, int32_t len);
+    void planGainSegment(int32_t len);
+    bool gainsSettled() const;
+    void planGainSegmentLinear(int32_t len);
+    float getSegmentGain(int32_t slot) const;
+    float getSegmentGainStep(int32_t slot) const;
+
+    // scheduler.mbt
+    int64_t sampleClock_ = 0;
+    double nextSpawnTime_ = 0.0;
+    float grainJitter_ = 0.25f;
+    std::array<int64_t, SPAWN_QUEUE_CAPACITY> queueTimes_{};
+    std::array<int32_t, SPAWN_QUEUE_CAPACITY> queueSlots_{};
+    std::array<int32_t, SPAWN_QUEUE_CAPACITY> queueVoices_{};
+    int32_t queueCount_ = 0;
+
+    void resetScheduler();
+    double getSpawnInterval() const;
+    bool enqueueStart(int64_t time, int32_t slot, int32_t voice);
+    void scheduleSegment(int32_t len);
+
+    // render.mbt
+    std::array<float, RAMP_SEGMENT_LENGTH> segmentMix_{};
+    float mixNorm_ = 1.0f;
+    int32_t renderPart_ = 0;
+    int32_t renderPartCount_ = 1;
+
+    float mixNormTarget() const;
+    void renderSegment(int32_t leftOutPtr, int32_t rightOutPtr, int32_t offset, int32_t len);
+    bool renderGrain(int32_t index, int32_t len, bool reverse, int64_t step, int64_t stepInc);
+    bool skipGrain(int32_t index, int32_t len, int64_t step, int64_t stepInc);
+    bool skipGrainSamples(Grain& grain, int32_t first, int32_t len, int64_t step, int64_t stepInc);
+
+    // modulation.mbt
+    int32_t modFlags_ = 0;
+    int32_t modCapacity_ = 0;
+    int32_t modReadOffset_ = 0;
+    int32_t modLanesPtr_ = 0;
+    bool blendWasModulated_ = false;
+
+    void beginModulationBlock(int32_t statePtr, int32_t numSamples);
+    bool isModulated(int32_t lane) const { return ((modFlags_ >> lane) & 1) != 0; }
+    bool isBlendModulated() const;
+    float getModulation(int32_t lane, int32_t index) const;
+    int32_t planSegment(int32_t offset, int32_t maxLen);
+
+    // events.mbt
+    int32_t eventsPtr_ = 0;
+    int32_t eventCount_ = 0;
+    int32_t eventCursor_ = 0;
+
+    void beginEventBlock(int32_t statePtr);
+    void applyEventsUntil(int32_t offset);
+    int32_t nextEventOffset(int32_t blockEnd) const;
+    void applyEvent(int32_t type, float value, int32_t data);
+
+    // voices.mbt
+    std::array<int32_t, MAX_VOICES> voiceNote_;
+    std::array<float, MAX_VOICES> voiceVelocity_{};
+    std::array<int32_t, MAX_VOICES> voiceAge_{};
+    std::array<double, MAX_VOICES> voiceNextSpawn_{};
+    std::array<int32_t, MAX_VOICES> voiceNextSlot_{};
+    int32_t voiceCounter_ = 0;
+    int32_t noteMode_ = 0;
+
+    void noteOn(int32_t note, float velocity);
+    void noteOff(int32_t note);
+    void allNotesOff();
+    float notePitchRatio(int32_t note) const;
+    int32_t velocityToOverlap(float velocity) const;
+    int32_t voiceSlot(int32_t voice);
+    int32_t spawnVoiceGrain(int32_t voice, int32_t wait);
+    void scheduleVoices(double startTime, double endTime);
+
+    // capture.mbt
+    int32_t liveInputSlot_ = -1;
+    int32_t captureWrite_ = 0;
+    int32_t captureDelay_ = 0;
+    int32_t captureWindow_ = 48000;
+
+    int32_t setLiveInputSlot(int32_t slot);
+    bool isLiveInputSlot(int32_t slot) const { return slot >= 0 && slot == liveInputSlot_; }
+    void captureInput(int32_t leftPtr, int32_t rightPtr, int32_t offset, int32_t len);
+    int32_t liveGrainStart(int32_t length, float speed);
+
+    // freeze_cache.mbt
+    int32_t freezeCacheState_ = 0;
+    int32_t freezeCachePeriod_ = 0;
+    float freezeCacheSpeed_ = 0.0f;
+    int64_t freezeCacheStep_ = 0;
+    int32_t freezeCacheWait_ = 0;
+    int32_t freezeCachePos_ = 0;
+    int32_t freezeCacheBase_ = 0;
+
+    int64_t segmentPhaseStep() const;
+    bool freezeMixSettled() const;
+    int32_t frozenCloudPeriod(int64_t step) const;
+    int32_t frozenCloudSettleTime(int64_t step) const;
+    void advanceFrozenGrains(int32_t count, int64_t step, int32_t period);
+    void invalidateFreezeCache();
+    void beginFreezeCache(int64_t step);
+    void recordFreezeCache(int32_t outPtr, int32_t offset, int32_t len);
+    bool playFreezeCache(int32_t leftOutPtr, int32_t rightOutPtr, int32_t offset, int32_t len);
+
+    // interp.mbt
+    int32_t interpMode_ = 0;
+
+    float loadClamped(int32_t ptr, int32_t slotLen, int32_t index) const;
+    float readInterpolated(int32_t ptr, int32_t slotLen, int64_t pos) const;
+    float readLinear(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const;
+    float readHermite(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const;
+    float readSinc(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const;
+};
+
+/** DspBackend running a NativeDSP */
+class NativeBackend : public DspBackend {
+public:
+    /** @return nullptr (with error set) if the linear memory is unavailable */
+    static std::unique_ptr<NativeBackend> create(std::string& error);
+
+    DspBackendType getType() const override { return DspBackendType::Native; }
+    uint8_t* getMemoryBase() override { return dsp_.getMemory(); }
+    uint64_t getMemorySize() override { return NativeDSP::MEMORY_BYTES; }
+    bool call(DspExport function, uint32_t numArgs, wasm_val_t* args,
+              int32_t* result = nullptr) override;
+    const char* getException() override { return exception_; }
+
+private:
+    NativeBackend() = default;
+
+    NativeDSP dsp_;
+    const char* exception_ = nullptr;
+};
+
+} // namespace suna
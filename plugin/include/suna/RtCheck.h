@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace suna {
+
+/** What a realtime thread did that it should not */
+enum class RtViolation : int {
+    Allocation,     // operator new, malloc, calloc, realloc, aligned_alloc, posix_memalign
+    Deallocation,   // operator delete, free
+    Lock,           // blocking mutex lock
+    FileIo,         // open, fopen, read, write
+    Count
+};
+
+/** "allocation", "deallocation", "lock" or "file_io" */
+const char* getRtViolationName(RtViolation kind);
+
+/**
+ * RtCheck - real-time safety checker for the audio callback
+ *
+ * A Scope marks the calling thread realtime (processBlock opens one while
+ * not rendering offline). Executables linking RtCheckHooks.cpp (the
+ * rt_check_test, and the Standalone app with -DSUNA_RT_CHECK=ON) intercept
+ * operator new/delete and, on glibc, malloc/free, pthread_mutex_lock and
+ * file I/O; when they run on a realtime thread the call is reported to
+ * stderr with a stack trace and counted. Non-blocking try_lock is allowed.
+ *
+ * The interceptors replace symbols of the executable, so they cannot see
+ * into a plugin loaded by a host. Nor can they see calls glibc makes to
+ * itself: stdio output (fwrite, fprintf, fflush, puts) ends in glibc's
+ * internal write, so only fopen and a buffer allocation on first use show
+ * up, not the blocking writes. Without the interceptors a Scope costs two
+ * thread-local increments.
+ */
+class RtCheck {
+public:
+    struct Report {
+        RtViolation kind;
+        std::string call;       // e.g. "malloc"
+        std::string stack;      // one frame per line (empty without backtrace support)
+        uint64_t count = 0;     // times this call site was hit
+    };
+
+    /** Marks the calling thread realtime while it exists (nests) */
+    class Scope {
+    public:
+        explicit Scope(bool realtime = true);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool realtime_;
+    };
+
+    /** Lets a known one-off violation through, e.g. per-thread setup */
+    class Disabler {
+    public:
+        Disabler();
+        ~Disabler();
+
+        Disabler(const Disabler&) = delete;
+        Disabler& operator=(const Disabler&) = delete;
+    };
+
+    /** True while the calling thread is realtime and not disabled */
+    static bool isChecking();
+
+    /** Record a violation by the calling thread (interceptors call this) */
+    static void report(RtViolation kind, const char* call);
+
+    static uint64_t getViolationCount();
+    static uint64_t getViolationCount(RtViolation kind);
+
+    /** One report per distinct call site, in the order first seen */
+    static std::vector<Report> getReports();
+
+    static void reset();
+
+    /** Abort at the first violation, for a debugger (default: report and go on) */
+    static void setAbortOnViolation(bool abortOnViolation);
+};
+
+} // namespace suna
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if SUNA_SHARED_SAMPLES
+#include "wasm_export.h"
+#endif
+
+namespace suna {
+
+/** One immutable sample in the shared store */
+struct SharedSample {
+    uint64_t hash;        // content hash (FNV-1a over the PCM bytes)
+    uint64_t appOffset;   // address inside every attached module instance
+    const float* data;    // native address of the same memory
+    int length;           // samples
+};
+
+/**
+ * SampleHeap - memory the SampleStore keeps sample data in
+ *
+ * An address it hands out reads the same bytes in every module instance
+ * using the heap. Plugin builds use WamrSampleHeap.
+ */
+class SampleHeap {
+public:
+    virtual ~SampleHeap() = default;
+
+    /**
+     * @param native Set to the native address of the new bytes
+     * @return App address of `bytes` new bytes, or 0 if the heap is full
+     */
+    virtual uint64_t allocate(size_t bytes, void*& native) = 0;
+
+    virtual void free(uint64_t appOffset) = 0;
+};
+
+/**
+ * SampleStore - process-wide, reference-counted store of sample data
+ *
+ * Samples live in one SampleHeap shared by every module instance of the
+ * process, so instances loading the same content (found by its hash) read
+ * one copy at the same app address. An entry is freed when the last slot
+ * holding it is cleared or reloaded. Entries keep their heap alive, so
+ * replacing the heap never frees memory a slot still reads.
+ */
+class SampleStore {
+public:
+    static SampleStore& instance();
+
+    SampleStore() = default;
+
+    SampleStore(const SampleStore&) = delete;
+    SampleStore& operator=(const SampleStore&) = delete;
+
+    /**
+     * Store new samples in `heap` (nullptr = none, acquire returns nullptr).
+     * Stored entries stay in their heap but are no longer shared.
+     */
+    void setHeap(std::shared_ptr<SampleHeap> heap);
+
+    /**
+     * Shared copy of the given samples, reusing an entry with equal content
+     * @return nullptr if there is no heap or it is full
+     */
+    std::shared_ptr<const SharedSample> acquire(const float* data, int length);
+
+    /** Distinct samples currently stored */
+    size_t getSampleCount();
+
+    /** Bytes of sample data currently stored */
+    size_t getBytesInUse();
+
+    static uint64_t hashSamples(const float* data, int length);
+
+private:
+    std::shared_ptr<const SharedSample> allocate(uint64_t hash, const float* data, int length);
+    void release(SharedSample* sample, SampleHeap& heap);
+
+    // Recursive: dropping a reference inside acquire() may run release()
+    std::recursive_mutex mutex_;
+    std::shared_ptr<SampleHeap> heap_;
+    std::unordered_map<uint64_t, std::weak_ptr<const SharedSample>> samples_;
+    size_t bytesInUse_ = 0;
+};
+
+#if SUNA_SHARED_SAMPLES
+/**
+ * WamrSampleHeap - a WAMR shared heap of HEAP_SIZE bytes
+ *
+ * Created once per WAMR runtime, from its pool, and attached to every
+ * module instance that reads the samples. Allocation goes through an
+ * attached instance; a free with none attached waits for the next attach.
+ *
+ * Requires a WAMR build with WAMR_BUILD_SHARED_HEAP=1 and an AOT module
+ * compiled with --enable-shared-heap (SUNA_SHARED_SAMPLES builds).
+ */
+class WamrSampleHeap : public SampleHeap {
+public:
+    static constexpr uint32_t HEAP_SIZE = 64 * 1024 * 1024;
+
+    /** @return nullptr if the runtime cannot create the heap */
+    static std::shared_ptr<WamrSampleHeap> create();
+
+    /**
+     * Map the heap into a module instance
+     * @return false if the instance cannot attach it
+     */
+    bool attach(wasm_module_inst_t moduleInst);
+
+    /** Call before deinstantiating an attached instance */
+    void detach(wasm_module_inst_t moduleInst);
+
+    uint64_t allocate(size_t bytes, void*& native) override;
+    void free(uint64_t appOffset) override;
+
+private:
+    explicit WamrSampleHeap(wasm_shared_heap_t heap) : heap_(heap) {}
+
+    std::mutex mutex_;
+    wasm_shared_heap_t heap_;
+    std::vector<wasm_module_inst_t> attached_;
+    std::vector<uint64_t> pendingFrees_;
+};
+#endif
+
+} // namespace suna
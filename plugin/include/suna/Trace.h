@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace suna {
+
+/**
+ * Trace - optional timeline of spans on the audio, worker and loader threads
+ *
+ * Every thread that records gets its own ring of the most recent
+ * EVENTS_PER_THREAD events, so recording takes no lock and does not
+ * allocate (the rings are allocated once, by the first start()). While
+ * stopped, a span costs one relaxed load.
+ *
+ * A thread gives its ring back when it exits; the ring keeps that thread's
+ * events until another thread claims it. While all MAX_THREADS rings are
+ * held, further threads record nothing; the trace counts them in an
+ * "untraced_threads" event.
+ *
+ * writeChromeTrace() dumps the rings as Chrome trace JSON, viewable in
+ * Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Usage:
+ *   Trace::start();
+ *   { TraceSpan span("process_block"); ... }
+ *   Trace::writeChromeTrace("trace.json", error);
+ */
+class Trace {
+public:
+    static constexpr int MAX_THREADS = 16;
+    static constexpr uint32_t EVENTS_PER_THREAD = 32768;
+
+    /** Clear the rings and start recording (not on the audio thread the first time) */
+    static void start();
+    static void stop();
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /** Label the calling thread in the trace (first name given wins) */
+    static void setThreadName(const char* name);
+
+    /** A span; name must outlive the trace (a string literal) */
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /** A point in time, e.g. a dropped block */
+    static void instant(const char* name);
+
+    /**
+     * Write everything recorded so far as Chrome trace JSON
+     *
+     * Recording pauses while the rings are copied and then resumes.
+     * @return false (with error set) if nothing was started or the file
+     *         cannot be written
+     */
+    static bool writeChromeTrace(const std::string& path, std::string& error);
+
+    static uint64_t nowNs();
+
+private:
+    static std::atomic<bool> enabled_;
+
+    static void append(const char* name, uint64_t startNs, uint64_t durationNs);
+    static void pauseRecording();
+};
+
+/** Records the time from construction to destruction as one span */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(Trace::isEnabled() ? name : nullptr), startNs_(name_ ? Trace::nowNs() : 0) {}
+    ~TraceSpan() {
+        if (name_) Trace::record(name_, startNs_, Trace::nowNs());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint64_t startNs_;
+};
+
+} // namespace suna
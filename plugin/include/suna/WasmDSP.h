@@ -1,18 +1,98 @@
 #pragma once
 
+#include "suna/DspBackend.h"
+#include "suna/DspLoadMeter.h"
 #include "wasm_export.h"
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstddef>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace suna {
 
+struct SharedSample;
+class WamrSampleHeap;
+
+/** Parameters that can follow a per-sample buffer instead of their setter */
+enum class ModulationLane : int {
+    BlendX = 0,
+    BlendY = 1,
+    Speed = 2
+};
+
+/** Event types of the per-block event list (match the MoonBit event_* constants) */
+enum class EventType : int32_t {
+    BlendX = 0,
+    BlendY = 1,
+    PlaybackSpeed = 2,
+    SpeedTarget = 3,
+    GrainLength = 4,
+    GrainDensity = 5,
+    Freeze = 6,
+    Interpolation = 7,
+    GrainJitter = 8,
+    MaxOverlap = 9,
+    PlayAll = 10,
+    StopAll = 11,
+    NoteOn = 12,       // value = velocity 0..1, data = note number
+    NoteOff = 13,      // data = note number
+    AllNotesOff = 14,
+    NoteMode = 15      // value = 0 (notes transpose) or 1 (notes select the slot)
+};
+
+/** One event record as laid out in WASM memory */
+struct DspEvent {
+    int32_t offset;  // sample offset within the block
+    int32_t type;    // EventType
+    float value;
+    int32_t data;
+};
+static_assert(sizeof(DspEvent) == 16, "DspEvent must match the MoonBit record layout");
+
+/** Why processBlock output silence instead of a rendered block */
+enum class DropReason : int {
+    ThreadEnvInit = 0,      // WAMR thread env could not be set up on the calling thread
+    NotPrepared = 1,        // no successful prepareToPlay yet
+    LockContention = 2,     // WASM lock held by another thread (realtime only)
+    MemoryUnavailable = 3,  // WASM memory or the I/O buffers could not be resolved
+    WasmException = 4,      // the DSP call trapped
+    WorkerException = 5,    // a render worker's share of the call trapped
+    Count = 6
+};
+
+const char* getDropReasonName(DropReason reason);
+
+/** Block counters of one WasmDSP instance since it was constructed */
+struct DspStats {
+    uint64_t blocks = 0;         // processBlock calls with samples
+    uint64_t splitBlocks = 0;    // larger than prepared: rendered in chunks, not dropped
+    uint64_t lateWorkerShares = 0;  // worker shares the audio thread rendered at the deadline
+    std::array<uint64_t, static_cast<size_t>(DropReason::Count)> dropped{};
+
+    uint64_t getDropped(DropReason reason) const { return dropped[static_cast<size_t>(reason)]; }
+    uint64_t getTotalDropped() const;
+};
+
+/**
+ * Called on the audio thread for every dropped block, with the count of
+ * drops for that reason so far; must not block or allocate
+ */
+using DropCallback = void (*)(DropReason reason, uint64_t count, void* context);
+
 /**
  * WasmDSP - C++ wrapper for MoonBit DSP functions via WAMR
  * 
  * Encapsulates WAMR runtime and provides a clean interface for calling
  * MoonBit DSP functions. This is a pure WAMR wrapper with no JUCE dependencies.
+ * The engine behind it is a DspBackend: the AOT module run by WAMR, or the
+ * same DSP compiled natively (NativeDSP) for comparing the two.
  * 
  * Usage:
  *   WasmDSP dsp;
@@ -38,15 +118,72 @@ public:
      * Initialize WAMR runtime and load AOT module
      * @param aotData Pointer to AOT binary data
      * @param size Size of AOT binary in bytes
+     * @param renderThreads Threads the grain cloud is rendered on (1 to
+     *        MAX_RENDER_THREADS). Each extra thread runs its own module
+     *        instance that receives every call, renders a share of the
+     *        grains and is summed into the output. Falls back to one
+     *        thread if a worker cannot be created.
+     * @param backend Engine to run; the native backend ignores aotData
+     *        and does not initialize the WAMR runtime.
      * @return true on success, false on failure
      */
-    bool initialize(const uint8_t* aotData, size_t size);
+    bool initialize(const uint8_t* aotData, size_t size, int renderThreads = 1,
+                    DspBackendType backend = DspBackendType::WamrAot);
+
+    DspBackendType getBackendType() const { return backendType_; }
 
     void prepareToPlay(double sampleRate, int maxBlockSize);
 
+    /**
+     * Render numSamples samples. Blocks larger than the maxBlockSize given to
+     * prepareToPlay are split into chunks that fit the I/O region.
+     */
     void processBlock(const float* leftIn, const float* rightIn,
                       float* leftOut, float* rightOut, int numSamples);
 
+    /**
+     * Render every block in fixed chunks of this many samples (0 = chunks
+     * as large as the prepared block size)
+     * 
+     * A small quantum (e.g. 64) makes timing independent of the host buffer
+     * size. Event offsets stay relative to the host block.
+     */
+    void setProcessingQuantum(int samples);
+
+    /**
+     * Switch to offline rendering (e.g. a bounce)
+     * 
+     * While non-realtime, processBlock waits for the WASM lock instead of
+     * skipping the block, and renders in chunks of at least
+     * NON_REALTIME_BLOCK_SIZE samples (ignoring the fixed quantum). Set it
+     * before prepareToPlay so the larger I/O region is allocated.
+     */
+    void setNonRealtime(bool nonRealtime);
+    bool isNonRealtime() const { return nonRealtime_.load(); }
+
+    static constexpr int NON_REALTIME_BLOCK_SIZE = 4096;
+
+    /**
+     * Largest block the four I/O buffers hold below the sample slots
+     * ((SAMPLE_DATA_START - BUFFER_START) / (4 * sizeof(float))). Larger
+     * prepared sizes are clamped; processBlock renders longer blocks in
+     * chunks.
+     */
+    static constexpr int MAX_IO_BLOCK_SIZE = 6250;
+
+    /** Threads currently rendering the grain cloud (1 = no workers) */
+    int getRenderThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+    static constexpr int MAX_RENDER_THREADS = 8;
+
+    /**
+     * Below this chunk size (the block, or the processing quantum) the
+     * hand-off to workers costs more than it saves: the audio thread renders
+     * every worker's share itself, on the worker's instance, so the
+     * instances stay in step for the next larger chunk.
+     */
+    static constexpr int MIN_PARALLEL_BLOCK_SIZE = 128;
+
     void loadSample(int slot, const float* data, int length);
     void clearSlot(int slot);
     void playAll();
@@ -60,6 +197,132 @@ public:
     void setFreeze(int value);
     void setSpeedTarget(float target);
 
+    /**
+     * Select the grain sample reader (nearest until set)
+     * @param mode 0 = nearest, 1 = linear, 2 = cubic Hermite, 3 = windowed sinc
+     */
+    void setInterpolation(int mode);
+
+    /**
+     * Grain pool size for the next prepareToPlay, which sizes the pool once
+     * (clamped to MIN_GRAIN_POOL_SIZE..MAX_GRAIN_POOL_SIZE). The pool does
+     * not change while playing.
+     * @return Pool size the next prepare will use
+     */
+    int setGrainPoolSize(int size);
+
+    static constexpr int MIN_GRAIN_POOL_SIZE = 100;
+    static constexpr int MAX_GRAIN_POOL_SIZE = 2000;
+
+    /** Random spread of grain start times, as a fraction of the spawn interval */
+    void setGrainJitter(float amount);
+
+    /** Upper bound on overlapping grains that density 1.0 maps to */
+    void setMaxOverlap(int count);
+
+    /**
+     * Granulate the plugin input in a slot (-1 = off)
+     * 
+     * The DSP records the mono mix of the input into a capture ring in its
+     * memory (CAPTURE_RING_SAMPLES long) and the slot's grains read from it,
+     * starting between the capture delay and delay + window samples behind
+     * the newest input. The slot's sample is dropped; loading or clearing a
+     * sample in the slot turns live input off. The input is only staged
+     * into WASM memory while live input is on.
+     */
+    void setLiveInput(int slot);
+    int getLiveInputSlot() const { return liveInputSlot_.load(); }
+
+    /** Shortest distance of a live grain start behind the input, in samples */
+    void setCaptureDelay(int samples);
+
+    /** Random spread of live grain starts beyond the capture delay, in samples */
+    void setCaptureWindow(int samples);
+
+    static constexpr int CAPTURE_RING_SAMPLES = 960000;
+
+    /**
+     * Heap objects the DSP has allocated, summed over the render instances
+     * (get_allocation_count). Constant across processBlock and parameter
+     * setters once prepared.
+     * @return Allocation count, or -1 if not initialized
+     */
+    int64_t getAllocationCount();
+
+    /**
+     * Per-sample modulation buffer for a lane, in WASM memory
+     * 
+     * Holds maxBlockSize floats. Fill the first numSamples values before each
+     * processBlock call while the lane is enabled; the DSP reads them
+     * directly, so modulation costs no extra WASM calls. In blocks larger
+     * than maxBlockSize, the lane is ignored past its capacity.
+     * @return Buffer pointer, or nullptr if not prepared
+     */
+    float* getModulationBuffer(ModulationLane lane);
+
+    /**
+     * Drive a parameter from its modulation buffer (audio thread safe)
+     * 
+     * While enabled, the lane overrides the scalar setter; disabling it
+     * returns to the last value set through the setter.
+     */
+    void setModulationEnabled(ModulationLane lane, bool enabled);
+
+    /**
+     * Schedule an event at a sample offset of the next processBlock call
+     * 
+     * Audio thread only (call before processBlock). The DSP splits rendering
+     * at event offsets, so the change lands on that exact sample.
+     * @return false if the block's event list is full
+     */
+    bool queueEvent(int sampleOffset, EventType type, float value, int data = 0);
+
+    /**
+     * Post a parameter event from a non-audio thread (lock-free)
+     * 
+     * Applied at the start of the next processed block, without taking the
+     * WASM lock, so UI changes never make the audio thread skip a block.
+     * Each type holds one value: posting again before that block replaces
+     * it, so only the latest value is applied.
+     * @return false for the types posting cannot hold (play, stop and note
+     *         events, whose order or note number matters)
+     */
+    bool postEvent(EventType type, float value);
+
+    /**
+     * Time of every processBlock call relative to its block duration
+     * 
+     * Safe to read from any thread; take a snapshot at UI rate. Reset by
+     * prepareToPlay.
+     */
+    DspLoadMeter& getLoadMeter() { return loadMeter_; }
+
+    /**
+     * Processed, split and dropped block counts (any thread)
+     * 
+     * A dropped block is output as silence; the counters attribute it to
+     * one DropReason.
+     */
+    DspStats getStats() const;
+
+    /**
+     * Be told about every dropped block (nullptr = no callback)
+     * 
+     * Set while no block is being processed, e.g. before prepareToPlay.
+     */
+    void setDropCallback(DropCallback callback, void* context = nullptr);
+
+    /**
+     * Time spent in each DSP function since initialize, hottest (self
+     * time) first, summed over the render workers
+     * 
+     * Needs a SUNA_WASM_PROFILING build (profiling libiwasm and AOT module)
+     * and the WAMR backend. Takes the WASM lock; call after a run, not
+     * from the audio thread.
+     * @return false if this build or backend cannot profile
+     */
+    bool getProfile(std::vector<FunctionProfile>& functions);
+
     void shutdown();
 
     /**
@@ -69,27 +332,13 @@ public:
 
 private:
     wasm_module_t module_ = nullptr;
-    wasm_module_inst_t moduleInst_ = nullptr;
-    wasm_exec_env_t execEnv_ = nullptr;
+    bool runtimeInitialized_ = false;   // holds a runtime reference
+    DspBackendType backendType_ = DspBackendType::WamrAot;
+    std::unique_ptr<DspBackend> backend_;
 
     std::recursive_mutex wasmMutex_;
     uint8_t* memBase_ = nullptr;
 
-    wasm_function_inst_t initSamplerFunc_ = nullptr;
-    wasm_function_inst_t loadSampleFunc_ = nullptr;
-    wasm_function_inst_t clearSlotFunc_ = nullptr;
-    wasm_function_inst_t playAllFunc_ = nullptr;
-    wasm_function_inst_t stopAllFunc_ = nullptr;
-    wasm_function_inst_t getSlotLengthFunc_ = nullptr;
-    wasm_function_inst_t processBlockFunc_ = nullptr;
-    wasm_function_inst_t setBlendXFunc_ = nullptr;
-    wasm_function_inst_t setBlendYFunc_ = nullptr;
-    wasm_function_inst_t setPlaybackSpeedFunc_ = nullptr;
-    wasm_function_inst_t setGrainLengthFunc_ = nullptr;
-    wasm_function_inst_t setGrainDensityFunc_ = nullptr;
-    wasm_function_inst_t setFreezeFunc_ = nullptr;
-    wasm_function_inst_t setSpeedTargetFunc_ = nullptr;
-
     uint32_t leftInOffset_ = 0;
     uint32_t rightInOffset_ = 0;
     uint32_t leftOutOffset_ = 0;
@@ -101,21 +350,108 @@ private:
     float* nativeRightOut_ = nullptr;
     float* nativeSampleData_ = nullptr;
 
+    // MoonBit's heap (heap-start-address in moon.pkg.json) runs up to the
+    // audio buffers
+    static constexpr uint32_t BUFFER_START = 900000;
     static constexpr uint32_t SAMPLE_DATA_START = 1000000;
+    static constexpr int MAX_SLOTS = 8;
+
+    // Slot data held in the process-wide SampleStore (SUNA_SHARED_SAMPLES)
+    std::array<std::shared_ptr<const SharedSample>, MAX_SLOTS> slotSamples_;
+    static constexpr uint32_t CONTROL_REGION_START = 54000000;
+    static constexpr uint32_t CONTROL_HEADER_BYTES = 16;
+    static constexpr int MODULATION_LANE_COUNT = 3;
+
+    // Written and read by the DSP only: each input sample is stored twice,
+    // so the ring takes 2 * CAPTURE_RING_SAMPLES floats
+    static constexpr uint32_t CAPTURE_RING_START = 56000000;
+    std::atomic<int> liveInputSlot_{-1};
+
+    std::atomic<uint32_t> modulationFlags_{0};
+    std::atomic<int> processingQuantum_{0};
+    std::atomic<bool> nonRealtime_{false};
+
+    static constexpr int MAX_BLOCK_EVENTS = 1024;
+    std::array<DspEvent, MAX_BLOCK_EVENTS> blockEvents_{};
+    int numBlockEvents_ = 0;
+
+    // Latest posted value per EventType; bit n of postedTypes_ = type n
+    // waits for the next block
+    static constexpr int POSTED_EVENT_TYPES = static_cast<int>(EventType::NoteMode) + 1;
+    std::array<std::atomic<float>, POSTED_EVENT_TYPES> postedValues_{};
+    std::atomic<uint32_t> postedTypes_{0};
 
     int maxBlockSize_ = 0;
+    double sampleRate_ = 0.0;
+    int grainPoolSize_ = MIN_GRAIN_POOL_SIZE;   // applied by prepareToPlay
+    DspLoadMeter loadMeter_;
+
+    std::atomic<uint64_t> processedBlocks_{0};
+    std::atomic<uint64_t> splitBlocks_{0};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(DropReason::Count)> droppedBlocks_{};
+    DropCallback dropCallback_ = nullptr;
+    void* dropCallbackContext_ = nullptr;
     std::atomic<bool> initialized_{false};
     std::atomic<bool> prepared_{false};
 
+    // A worker's share of the current chunk: queued by the audio thread,
+    // claimed by whichever thread renders it first
+    enum ShareState : int { ShareIdle, ShareQueued, ShareRendering, ShareDone };
+
+    /** Backend instance rendering one share of the grains on its own thread */
+    struct RenderWorker {
+        std::unique_ptr<DspBackend> backend;
+        uint8_t* memBase = nullptr;
+        std::thread thread;
+        std::atomic<int> share{ShareIdle};
+        bool failed = false;    // written by the share's renderer before ShareDone
+    };
+    std::vector<std::unique_ptr<RenderWorker>> workers_;
+
+    // Chunk hand-off: the audio thread queues every share, bumps
+    // workGeneration_ and wakes sleeping workers; a worker spins briefly
+    // for the next generation before it sleeps on wakeCondition_
+    std::atomic<uint32_t> workGeneration_{0};
+    std::atomic<int> sleepingWorkers_{0};
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    std::atomic<bool> stopWorkers_{false};
+    int workerChunkSamples_ = 0;
+    std::atomic<uint64_t> lateWorkerShares_{0};
+
+    // The process-wide WAMR pool holds up to MAX_WAMR_INSTANCES module
+    // instances (every WasmDSP's main instance and workers), HEAP_BUF_SIZE each
     static constexpr size_t HEAP_BUF_SIZE = 128 * 1024 * 1024;
-    char heapBuf_[HEAP_BUF_SIZE];
+    static constexpr size_t MAX_WAMR_INSTANCES = 16;
+    static constexpr size_t WAMR_POOL_SIZE = HEAP_BUF_SIZE * MAX_WAMR_INSTANCES;
+
+    // Attached to the main instance and every worker, or not used at all
+    // (SUNA_SHARED_SAMPLES)
+    std::shared_ptr<WamrSampleHeap> sampleHeap_;
+    bool sharedSamples_ = false;
 
     uint8_t* aotDataCopy_ = nullptr;
     size_t aotDataSize_ = 0;
 
-    bool lookupFunctions();
+    bool initializeRuntime(const uint8_t* aotData, size_t size);
+    bool acquireRuntime();      // a reference to the process-wide runtime
+    void releaseRuntime();
+    std::unique_ptr<DspBackend> createBackend(std::string& error);
     bool allocateBuffers(int maxBlockSize);
     bool refreshMemoryBase();
+    bool processChunk(const float* leftIn, const float* rightIn,
+                      int chunkStart, int numSamples, int& nextEvent);
+    uint64_t recordDrop(DropReason reason);
+    bool startWorkers(int count);
+    void stopWorkers();
+    void workerLoop(RenderWorker& worker, uint32_t seen);
+    bool renderShare(RenderWorker& worker);
+    bool waitForShares(std::chrono::steady_clock::time_point claimDeadline);
+    void setRenderPartition(DspBackend& backend, int index, int count);
+    void callWorkers(DspExport function, uint32_t numArgs, wasm_val_t* args);
+    void copyControlToWorkers(int chunkStart, int numSamples, int numEvents);
+    void stageInput(const float* leftIn, const float* rightIn, int numSamples);
+    int writeEventList(int chunkStart, int numSamples, int& nextEvent);
 };
 
 } // namespace suna
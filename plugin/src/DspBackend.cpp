@@ -0,0 +1,193 @@
+#include "suna/DspBackend.h"
+#if SUNA_WASM_PROFILING
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#endif
+
+#if SUNA_WASM_PROFILING
+// libiwasm prints through this when built with
+// -DWAMR_BH_VPRINTF=suna_wamr_vprintf; a thread capturing the profiling
+// dump gets its output instead of stdout
+static thread_local std::string* wamrCapture = nullptr;
+
+extern "C" int suna_wamr_vprintf(const char* format, va_list args) {
+    if (!wamrCapture) {
+        return std::vprintf(format, args);
+    }
+    char line[512];
+    const int length = std::vsnprintf(line, sizeof(line), format, args);
+    if (length > 0) {
+        wamrCapture->append(line, std::min<size_t>(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+    return length;
+}
+#endif
+
+namespace suna {
+
+static const char* const EXPORT_NAMES[] = {
+    "init_sampler",
+    "load_sample",
+    "clear_slot",
+    "play_all",
+    "stop_all",
+    "get_slot_length",
+    "process_block",
+    "set_blend_x",
+    "set_blend_y",
+    "set_playback_speed",
+    "set_grain_length",
+    "set_grain_density",
+    "set_freeze",
+    "set_speed_target",
+    "set_interpolation",
+    "set_grain_jitter",
+    "set_max_overlap",
+    "set_render_partition",
+    "set_live_input",
+    "set_capture_delay",
+    "set_capture_window",
+    "get_allocation_count",
+};
+static_assert(sizeof(EXPORT_NAMES) / sizeof(EXPORT_NAMES[0]) ==
+              static_cast<size_t>(DspExport::Count), "one name per DspExport");
+
+const char* getExportName(DspExport function) {
+    const int index = static_cast<int>(function);
+    if (index < 0 || index >= static_cast<int>(DspExport::Count)) return "";
+    return EXPORT_NAMES[index];
+}
+
+const char* getBackendName(DspBackendType type) {
+    return type == DspBackendType::Native ? "native" : "wamr";
+}
+
+bool parseBackendName(const std::string& name, DspBackendType& type) {
+    if (name == "wamr") {
+        type = DspBackendType::WamrAot;
+    } else if (name == "native") {
+        type = DspBackendType::Native;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<WamrBackend> WamrBackend::create(wasm_module_t module, uint32_t stackSize,
+                                                 uint32_t heapSize, std::string& error) {
+    std::unique_ptr<WamrBackend> backend(new WamrBackend());
+    char errorBuf[128];
+    backend->moduleInst_ = wasm_runtime_instantiate(module, stackSize, heapSize,
+                                                    errorBuf, sizeof(errorBuf));
+    if (!backend->moduleInst_) {
+        error = std::string("wasm_runtime_instantiate failed - ") + errorBuf;
+        return nullptr;
+    }
+
+    backend->execEnv_ = wasm_runtime_create_exec_env(backend->moduleInst_, stackSize);
+    if (!backend->execEnv_) {
+        error = "wasm_runtime_create_exec_env failed";
+        return nullptr;
+    }
+
+    for (int i = 0; i < static_cast<int>(DspExport::Count); ++i) {
+        const char* name = EXPORT_NAMES[i];
+        backend->functions_[i] = wasm_runtime_lookup_function(backend->moduleInst_, name);
+        if (!backend->functions_[i]) {
+            error = std::string("missing export ") + name;
+            return nullptr;
+        }
+    }
+    return backend;
+}
+
+WamrBackend::~WamrBackend() {
+    if (execEnv_) {
+        wasm_runtime_destroy_exec_env(execEnv_);
+    }
+    if (moduleInst_) {
+        wasm_runtime_deinstantiate(moduleInst_);
+    }
+}
+
+uint8_t* WamrBackend::getMemoryBase() {
+    return static_cast<uint8_t*>(wasm_runtime_addr_app_to_native(moduleInst_, 0));
+}
+
+uint64_t WamrBackend::getMemorySize() {
+    wasm_memory_inst_t memoryInst = wasm_runtime_get_default_memory(moduleInst_);
+    if (!memoryInst) return 0;
+    return wasm_memory_get_cur_page_count(memoryInst) *
+           wasm_memory_get_bytes_per_page(memoryInst);
+}
+
+bool WamrBackend::call(DspExport function, uint32_t numArgs, wasm_val_t* args,
+                       int32_t* result) {
+    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
+    const bool success = wasm_runtime_call_wasm_a(
+        execEnv_, functions_[static_cast<size_t>(function)], 1, results, numArgs, args);
+    if (result) {
+        *result = results[0].of.i32;
+    }
+    return success;
+}
+
+const char* WamrBackend::getException() {
+    return wasm_runtime_get_exception(moduleInst_);
+}
+
+#if SUNA_WASM_PROFILING
+bool WamrBackend::getProfile(std::vector<FunctionProfile>& functions) {
+    // WAMR only prints its per-function records, one line per function:
+    //   func NAME, execution time: T ms, execution count: N times,
+    //   children execution time: C ms
+    std::string dump;
+    wamrCapture = &dump;
+    wasm_runtime_dump_perf_profiling(moduleInst_);
+    wamrCapture = nullptr;
+
+    static const char* const TIME_FIELD = ", execution time: ";
+    functions.clear();
+    std::istringstream lines(dump);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t nameStart = line.find("func ");
+        const size_t nameEnd = line.rfind(TIME_FIELD);
+        if (nameStart == std::string::npos || nameEnd == std::string::npos || nameEnd < nameStart) {
+            continue;
+        }
+        double totalMs = 0.0;
+        double childrenMs = 0.0;
+        unsigned long long calls = 0;
+        if (std::sscanf(line.c_str() + nameEnd + std::strlen(TIME_FIELD),
+                        "%lf ms, execution count: %llu times, children execution time: %lf ms",
+                        &totalMs, &calls, &childrenMs) != 3) {
+            continue;
+        }
+        std::string name = line.substr(nameStart + 5, nameEnd - nameStart - 5);
+        if (!name.empty() && name.find_first_not_of("0123456789") == std::string::npos) {
+            name = "func " + name;
+        }
+        functions.push_back({ std::move(name), totalMs,
+                              std::max(0.0, totalMs - childrenMs), calls });
+    }
+    return true;
+}
+
+std::string WamrBackend::getCallStack() {
+    const uint32_t size = wasm_runtime_get_call_stack_buf_size(execEnv_);
+    if (size == 0) return {};
+    std::string stack(size, '\0');
+    const uint32_t written = wasm_runtime_dump_call_stack_to_buf(execEnv_, &stack[0], size);
+    stack.resize(std::min(written, size));
+    while (!stack.empty() && (stack.back() == '\0' || stack.back() == '\n')) {
+        stack.pop_back();
+    }
+    return stack;
+}
+#endif
+
+} // namespace suna
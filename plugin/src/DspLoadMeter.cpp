@@ -0,0 +1,64 @@
+#include "suna/DspLoadMeter.h"
+#include <algorithm>
+
+namespace suna {
+
+namespace {
+
+// Weight of the newest block in the smoothed load
+constexpr float AVERAGE_WEIGHT = 0.01f;
+
+} // namespace
+
+void DspLoadMeter::record(double elapsedSeconds, double blockSeconds) {
+    if (blockSeconds <= 0.0) return;
+    const float load = static_cast<float>(elapsedSeconds / blockSeconds);
+
+    const int bucket = std::clamp(static_cast<int>(load * 10.0f), 0, BUCKET_COUNT - 1);
+    increment(histogram_[static_cast<size_t>(bucket)]);
+    increment(blocks_);
+    if (load >= XRUN_RISK_LOAD) increment(xrunRisk_);
+    if (load >= 1.0f) increment(overruns_);
+
+    lastLoad_.store(load, std::memory_order_relaxed);
+    const float average = averageLoad_.load(std::memory_order_relaxed);
+    averageLoad_.store(average + AVERAGE_WEIGHT * (load - average), std::memory_order_relaxed);
+    if (load > maxLoad_.load(std::memory_order_relaxed)) {
+        maxLoad_.store(load, std::memory_order_relaxed);
+    }
+
+    // snapshot() may clear the peak concurrently, so raise it with a CAS
+    float peak = peakLoad_.load(std::memory_order_relaxed);
+    while (load > peak &&
+           !peakLoad_.compare_exchange_weak(peak, load, std::memory_order_relaxed)) {
+    }
+}
+
+DspLoadMeter::Snapshot DspLoadMeter::snapshot() {
+    Snapshot snapshot;
+    snapshot.blocks = blocks_.load(std::memory_order_relaxed);
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        snapshot.histogram[static_cast<size_t>(i)] =
+            histogram_[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+    }
+    snapshot.xrunRisk = xrunRisk_.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns_.load(std::memory_order_relaxed);
+    snapshot.lastLoad = lastLoad_.load(std::memory_order_relaxed);
+    snapshot.averageLoad = averageLoad_.load(std::memory_order_relaxed);
+    snapshot.maxLoad = maxLoad_.load(std::memory_order_relaxed);
+    snapshot.peakLoad = peakLoad_.exchange(0.0f, std::memory_order_relaxed);
+    return snapshot;
+}
+
+void DspLoadMeter::reset() {
+    for (auto& bucket : histogram_) bucket.store(0, std::memory_order_relaxed);
+    blocks_.store(0, std::memory_order_relaxed);
+    xrunRisk_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    lastLoad_.store(0.0f, std::memory_order_relaxed);
+    averageLoad_.store(0.0f, std::memory_order_relaxed);
+    maxLoad_.store(0.0f, std::memory_order_relaxed);
+    peakLoad_.store(0.0f, std::memory_order_relaxed);
+}
+
+} // namespace suna
@@ -0,0 +1,1566 @@
+#include "suna/NativeDSP.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// WASM never fuses a multiply and an add; contracting them here would make
+// the native output drift from the AOT module's
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace suna {
+
+namespace {
+
+// dsp/src/utils/constants.mbt
+constexpr int32_t FLOAT32_SIZE = 4;
+constexpr int32_t TOTAL_GRAIN_COUNT = 100;
+constexpr int32_t MIN_GRAIN_POOL_SIZE = 100;
+constexpr int32_t MIN_GRAIN_COUNT = 0;
+constexpr int PHASE_FRAC_BITS = 32;
+constexpr int64_t PHASE_ONE = int64_t(1) << PHASE_FRAC_BITS;
+constexpr int64_t PHASE_FRAC_MASK = PHASE_ONE - 1;
+constexpr float ENVELOPE_ATTACK_RATIO = 0.1f;
+constexpr float ENVELOPE_RELEASE_RATIO = 0.1f;
+
+constexpr int32_t INTERP_NEAREST = 0;
+constexpr int32_t INTERP_LINEAR = 1;
+constexpr int32_t INTERP_HERMITE = 2;
+constexpr int32_t INTERP_SINC = 3;
+constexpr int INTERP_TABLE_BITS = 10;
+constexpr int32_t INTERP_TABLE_SIZE = 1 << INTERP_TABLE_BITS;
+constexpr int INTERP_TABLE_SHIFT = PHASE_FRAC_BITS - INTERP_TABLE_BITS;
+constexpr int32_t SINC_TAPS = 8;
+constexpr double SINC_CUTOFF = 0.9;
+constexpr double PI = 3.141592653589793;
+
+constexpr float GAIN_SMOOTH_COEFF = 0.01f;
+
+constexpr int32_t FREEZE_CACHE_PTR = 48000000;
+constexpr int32_t FREEZE_CACHE_CAPACITY = 1440000;
+
+constexpr int32_t CAPTURE_RING_PTR = 56000000;
+constexpr int32_t CAPTURE_CAPACITY = 960000;
+
+constexpr int32_t MOD_HEADER_BYTES = 16;
+constexpr int32_t MOD_BLEND_X = 0;
+constexpr int32_t MOD_BLEND_Y = 1;
+constexpr int32_t MOD_SPEED = 2;
+constexpr int32_t MOD_LANE_COUNT = 3;
+
+constexpr int32_t EVENT_RECORD_BYTES = 16;
+constexpr int32_t MAX_BLOCK_EVENTS = 1024;
+
+constexpr int32_t ROOT_NOTE = 60;
+constexpr int32_t NOTE_MODE_PITCH = 0;
+constexpr int32_t NOTE_MODE_SLOT = 1;
+
+constexpr float SPEED_RAMP_TIME_MS = 200.0f;
+
+// freeze_cache.mbt states
+constexpr int32_t CACHE_IDLE = 0;
+constexpr int32_t CACHE_PRIMING = 1;
+constexpr int32_t CACHE_RECORDING = 2;
+constexpr int32_t CACHE_PLAYING = 3;
+
+/** MoonBit Float::to_int (saturating, NaN = 0) */
+int32_t toInt(float value) {
+    if (value != value) return 0;
+    if (value >= 2147483648.0f) return std::numeric_limits<int32_t>::max();
+    if (value <= -2147483648.0f) return std::numeric_limits<int32_t>::min();
+    return static_cast<int32_t>(value);
+}
+
+/** MoonBit Double::to_int64 (saturating, NaN = 0) */
+int64_t toInt64(double value) {
+    if (value != value) return 0;
+    if (value >= 9223372036854775808.0) return std::numeric_limits<int64_t>::max();
+    if (value <= -9223372036854775808.0) return std::numeric_limits<int64_t>::min();
+    return static_cast<int64_t>(value);
+}
+
+/** Speed (samples per output sample) as a fixed-point phase step */
+int64_t speedToPhaseStep(float speed) {
+    return toInt64(static_cast<double>(speed) * static_cast<double>(PHASE_ONE));
+}
+
+float phaseToFloat(int64_t phase) {
+    return static_cast<float>(static_cast<double>(phase) / static_cast<double>(PHASE_ONE));
+}
+
+/** Trapezoidal grain envelope, 0.0 to 1.0 */
+float calculateEnvelope(float currentPos, int32_t length) {
+    if (length <= 0) return 0.0f;
+    const float lenF = static_cast<float>(length);
+    if (currentPos < 0.0f || currentPos >= lenF) return 0.0f;
+
+    const float attackSamples = lenF * ENVELOPE_ATTACK_RATIO;
+    const float releaseStart = lenF * (1.0f - ENVELOPE_RELEASE_RATIO);
+    if (currentPos < attackSamples) {
+        return attackSamples > 0.0f ? currentPos / attackSamples : 1.0f;
+    }
+    if (currentPos >= releaseStart) {
+        const float releaseSamples = lenF - releaseStart;
+        return releaseSamples > 0.0f ? (lenF - currentPos) / releaseSamples : 0.0f;
+    }
+    return 1.0f;
+}
+
+/** Catmull-Rom coefficients, 4 per row, for taps x[-1], x[0], x[1], x[2] */
+std::vector<float> buildHermiteTable() {
+    std::vector<float> table(static_cast<size_t>(INTERP_TABLE_SIZE) * 4);
+    for (int32_t row = 0; row < INTERP_TABLE_SIZE; ++row) {
+        const double t = static_cast<double>(row) / static_cast<double>(INTERP_TABLE_SIZE);
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        const size_t base = static_cast<size_t>(row) * 4;
+        table[base] = static_cast<float>(-0.5 * t3 + t2 - 0.5 * t);
+        table[base + 1] = static_cast<float>(1.5 * t3 - 2.5 * t2 + 1.0);
+        table[base + 2] = static_cast<float>(-1.5 * t3 + 2.0 * t2 + 0.5 * t);
+        table[base + 3] = static_cast<float>(0.5 * t3 - 0.5 * t2);
+    }
+    return table;
+}
+
+/** Windowed-sinc coefficients, SINC_TAPS per row, for taps x[-3] .. x[4] */
+std::vector<float> buildSincTable() {
+    std::vector<float> table(static_cast<size_t>(INTERP_TABLE_SIZE) * SINC_TAPS);
+    const double half = static_cast<double>(SINC_TAPS / 2);
+    double weights[SINC_TAPS];
+    for (int32_t row = 0; row < INTERP_TABLE_SIZE; ++row) {
+        const double t = static_cast<double>(row) / static_cast<double>(INTERP_TABLE_SIZE);
+        double sum = 0.0;
+        for (int32_t k = 0; k < SINC_TAPS; ++k) {
+            const double x = static_cast<double>(k - SINC_TAPS / 2 + 1) - t;
+            const double arg = PI * x * SINC_CUTOFF;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(arg) / arg;
+            const double phase = PI * x / half;
+            const double window = 0.42 + 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            const double w = (x <= -half || x >= half) ? 0.0 : sinc * window;
+            weights[k] = w;
+            sum = sum + w;
+        }
+        for (int32_t k = 0; k < SINC_TAPS; ++k) {
+            table[static_cast<size_t>(row) * SINC_TAPS + k] = static_cast<float>(weights[k] / sum);
+        }
+    }
+    return table;
+}
+
+const std::vector<float>& hermiteTable() {
+    static const std::vector<float> table = buildHermiteTable();
+    return table;
+}
+
+const std::vector<float>& sincTable() {
+    static const std::vector<float> table = buildSincTable();
+    return table;
+}
+
+/** One-pole decay (1 - GAIN_SMOOTH_COEFF)^len for len = 0 .. RAMP_SEGMENT_LENGTH */
+const std::array<float, NativeDSP::RAMP_SEGMENT_LENGTH + 1>& gainDecayTable() {
+    static const auto table = [] {
+        std::array<float, NativeDSP::RAMP_SEGMENT_LENGTH + 1> t{};
+        const float oneMinusCoeff = 1.0f - GAIN_SMOOTH_COEFF;
+        t[0] = 1.0f;
+        for (size_t len = 1; len < t.size(); ++len) {
+            t[len] = t[len - 1] * oneMinusCoeff;
+        }
+        return t;
+    }();
+    return table;
+}
+
+} // namespace
+
+// ============================================
+// Linear memory
+// ============================================
+
+NativeDSP::NativeDSP() {
+    voiceNote_.fill(-1);
+    queueVoices_.fill(-1);
+    // Zeroed like a fresh WASM memory; calloc maps untouched pages lazily
+    memory_ = static_cast<uint8_t*>(std::calloc(MEMORY_BYTES, 1));
+    // Built here so the first process_block does not pay for them
+    hermiteTable();
+    sincTable();
+    gainDecayTable();
+}
+
+NativeDSP::~NativeDSP() {
+    std::free(memory_);
+}
+
+// Addresses are i32 offsets as in WASM (the slot layout keeps them in range)
+float NativeDSP::loadF32(int32_t ptr) const {
+    float value;
+    std::memcpy(&value, memory_ + static_cast<uint32_t>(ptr), sizeof(value));
+    return value;
+}
+
+void NativeDSP::storeF32(int32_t ptr, float value) {
+    std::memcpy(memory_ + static_cast<uint32_t>(ptr), &value, sizeof(value));
+}
+
+int32_t NativeDSP::loadI32(int32_t ptr) const {
+    int32_t value;
+    std::memcpy(&value, memory_ + static_cast<uint32_t>(ptr), sizeof(value));
+    return value;
+}
+
+// ============================================
+// Exports
+// ============================================
+
+int32_t NativeDSP::initSampler(float sampleRate, int32_t poolSize) {
+    sampleRate_ = sampleRate;
+    initSlots();
+    // Slots start empty again; a live input slot keeps its ring
+    setLiveInputSlot(liveInputSlot_);
+    initGrainPoolWithSize(poolSize);
+    grainPoolSizeSetting_ = poolSize_;
+    resetScheduler();
+    grainPoolInitialized_ = true;
+    previousSlotCount_ = slotCount_;
+    return grainPoolSizeSetting_;
+}
+
+int32_t NativeDSP::loadSample(int32_t slot, int32_t dataPtr, int32_t length) {
+    // A sample replaces the live input playing in the slot
+    if (isLiveInputSlot(slot)) {
+        setLiveInputSlot(-1);
+    }
+    return loadSampleToSlot(slot, dataPtr, length);
+}
+
+int32_t NativeDSP::clearSlot(int32_t slot) {
+    if (isLiveInputSlot(slot)) {
+        setLiveInputSlot(-1);
+    }
+    return clearSlotData(slot);
+}
+
+int32_t NativeDSP::playAll() {
+    startAllSlots();
+    return 0;
+}
+
+int32_t NativeDSP::stopAll() {
+    stopAllSlots();
+    return 0;
+}
+
+int32_t NativeDSP::getSlotLength(int32_t slot) {
+    return getSlotSampleLength(slot);
+}
+
+int32_t NativeDSP::processBlock(int32_t statePtr, int32_t leftInPtr, int32_t rightInPtr,
+                                int32_t leftOutPtr, int32_t rightOutPtr, int32_t numSamples) {
+    if (!grainPoolInitialized_) {
+        initGrainPoolWithSize(grainPoolSizeSetting_);
+        grainPoolInitialized_ = true;
+    }
+
+    // Reset the cloud when the slot count changes
+    if (slotCount_ != previousSlotCount_) {
+        distributeGrains(slotCount_);
+        previousSlotCount_ = slotCount_;
+    }
+    beginModulationBlock(statePtr, numSamples);
+    beginEventBlock(statePtr);
+    int32_t offset = 0;
+    while (offset < numSamples) {
+        // Apply the events due now; the segment ends at the next one
+        applyEventsUntil(offset);
+        const int32_t remaining = nextEventOffset(numSamples) - offset;
+        const int32_t maxLen = remaining < RAMP_SEGMENT_LENGTH ? remaining : RAMP_SEGMENT_LENGTH;
+        const int32_t len = planSegment(offset, maxLen);
+        captureInput(leftInPtr, rightInPtr, offset, len);
+        scheduleSegment(len);
+        if (!playFreezeCache(leftOutPtr, rightOutPtr, offset, len)) {
+            renderSegment(leftOutPtr, rightOutPtr, offset, len);
+            recordFreezeCache(leftOutPtr, offset, len);
+        }
+        offset = offset + len;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setBlendX(float value) {
+    blendX_ = value;
+    updateGains();
+    return 0;
+}
+
+int32_t NativeDSP::setBlendY(float value) {
+    blendY_ = value;
+    updateGains();
+    return 0;
+}
+
+int32_t NativeDSP::setPlaybackSpeed(float speed) {
+    applyPlaybackSpeed(speed);
+    return 0;
+}
+
+int32_t NativeDSP::setGrainLength(int32_t length) {
+    if (length > 0) {
+        invalidateFreezeCache();
+        grainLength_ = length;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setGrainDensity(float density) {
+    if (density >= 0.0f && density <= 1.0f) {
+        grainDensity_ = density;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setFreeze(int32_t value) {
+    applyFreeze(value != 0);
+    return 0;
+}
+
+int32_t NativeDSP::setSpeedTarget(float target) {
+    applySpeedTarget(target);
+    return 0;
+}
+
+int32_t NativeDSP::setInterpolation(int32_t mode) {
+    if (mode >= INTERP_NEAREST && mode <= INTERP_SINC) {
+        invalidateFreezeCache();
+        interpMode_ = mode;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setGrainJitter(float jitter) {
+    if (jitter >= 0.0f && jitter <= 1.0f) {
+        grainJitter_ = jitter;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setMaxOverlap(int32_t overlap) {
+    if (overlap > 0) {
+        maxOverlap_ = overlap;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setLiveInput(int32_t slot) {
+    return setLiveInputSlot(slot);
+}
+
+int32_t NativeDSP::setCaptureDelay(int32_t samples) {
+    if (samples >= 0 && samples < CAPTURE_CAPACITY) {
+        captureDelay_ = samples;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setCaptureWindow(int32_t samples) {
+    if (samples >= 0 && samples < CAPTURE_CAPACITY) {
+        captureWindow_ = samples;
+    }
+    return 0;
+}
+
+int32_t NativeDSP::setRenderPartition(int32_t index, int32_t count) {
+    if (count >= 1 && index >= 0 && index < count) {
+        // The loop cache holds this instance's share of the output
+        invalidateFreezeCache();
+        renderPart_ = index;
+        renderPartCount_ = count;
+    }
+    return 0;
+}
+
+// ============================================
+// Grains (grain.mbt)
+// ============================================
+
+float NativeDSP::Grain::position() const {
+    return phaseToFloat(phase);
+}
+
+int64_t NativeDSP::Grain::readPosition(bool reverse) const {
+    const int64_t start = static_cast<int64_t>(startPos) << PHASE_FRAC_BITS;
+    if (reverse) {
+        const int64_t mirrored = (static_cast<int64_t>(length - 1) << PHASE_FRAC_BITS) - phase;
+        return start + (mirrored < 0 ? 0 : mirrored);
+    }
+    return start + phase;
+}
+
+int32_t NativeDSP::getMaxOverlap() const {
+    return maxOverlap_ < poolSize_ ? maxOverlap_ : poolSize_;
+}
+
+int32_t NativeDSP::getActiveGrainCount() const {
+    const int32_t range = getMaxOverlap() - MIN_GRAIN_COUNT;
+    return MIN_GRAIN_COUNT + toInt(static_cast<float>(range) * grainDensity_);
+}
+
+int32_t NativeDSP::randomNext() {
+    // i32 arithmetic wraps, as in WASM
+    const uint32_t product = 1103515245u * static_cast<uint32_t>(randomSeed_) + 12345u;
+    randomSeed_ = static_cast<int32_t>(product) % 2147483647;
+    return randomSeed_;
+}
+
+int32_t NativeDSP::randomRange(int32_t min, int32_t max) {
+    if (max <= min) return min;
+    const int32_t range = max - min;
+    const int32_t randVal = randomNext();
+    const int32_t absRand = randVal < 0 ? -randVal : randVal;
+    return min + absRand % range;
+}
+
+float NativeDSP::randomUnit() {
+    return static_cast<float>(randomRange(0, 16777216)) / 16777216.0f;
+}
+
+void NativeDSP::reserveGrains() {
+    if (grains_.size() < static_cast<size_t>(MAX_GRAIN_POOL_SIZE)) {
+        allocationCount_ += MAX_GRAIN_POOL_SIZE - static_cast<int32_t>(grains_.size());
+        grains_.resize(MAX_GRAIN_POOL_SIZE);
+    }
+}
+
+void NativeDSP::initGrainPoolWithSize(int32_t size) {
+    const int32_t clampedSize = size < MIN_GRAIN_POOL_SIZE ? MIN_GRAIN_POOL_SIZE
+                              : size > MAX_GRAIN_POOL_SIZE ? MAX_GRAIN_POOL_SIZE
+                              : size;
+    invalidateFreezeCache();
+    reserveGrains();
+    for (int32_t i = 0; i < clampedSize; ++i) {
+        Grain& grain = grains_[i];
+        grain.slot = 0;
+        grain.startPos = 0;
+        grain.phase = 0;
+        grain.endPhase = 0;
+        grain.length = 0;
+        grain.pitch = 1.0f;
+        grain.amp = 1.0f;
+    }
+    poolSize_ = clampedSize;
+    stopAllGrains();
+}
+
+void NativeDSP::stopAllGrains() {
+    invalidateFreezeCache();
+    aliveCount_ = 0;
+    // Fill in reverse so grains are handed out in index order
+    for (int32_t i = 0; i < poolSize_; ++i) {
+        const int32_t index = poolSize_ - 1 - i;
+        grains_[index].active = 0;
+        grains_[index].wait = 0;
+        freeGrains_[i] = index;
+    }
+    freeCount_ = poolSize_;
+}
+
+void NativeDSP::respawnGrain(int32_t index) {
+    if (index < 0 || index >= poolSize_) return;
+    Grain& grain = grains_[index];
+    // Live input grains start behind the capture ring's write head
+    if (isLiveInputSlot(grain.slot)) {
+        const int32_t length = grainLength_ > CAPTURE_CAPACITY / 2 ? CAPTURE_CAPACITY / 2
+                                                                   : grainLength_;
+        grain.startPos = liveGrainStart(length, segmentSpeed_);
+        grain.phase = 0;
+        grain.endPhase = static_cast<int64_t>(length) << PHASE_FRAC_BITS;
+        grain.length = length;
+        grain.active = 1;
+        return;
+    }
+    const int32_t slotLength = getSlotSampleLength(grain.slot);
+    const int32_t clampedLength = grainLength_ > slotLength ? slotLength : grainLength_;
+    const int32_t maxStart = slotLength > clampedLength ? slotLength - clampedLength : 0;
+    grain.startPos = maxStart > 0 ? randomRange(0, maxStart + 1) : 0;
+    grain.phase = 0;
+    grain.endPhase = static_cast<int64_t>(clampedLength) << PHASE_FRAC_BITS;
+    grain.length = clampedLength;
+    grain.active = 1;
+}
+
+void NativeDSP::respawnSlotGrains(int32_t slot) {
+    for (int32_t i = 0; i < aliveCount_; ++i) {
+        const int32_t index = aliveGrains_[i];
+        if (grains_[index].slot == slot) {
+            respawnGrain(index);
+        }
+    }
+}
+
+int32_t NativeDSP::spawnGrain(int32_t slot, int32_t wait) {
+    return spawnPitchedGrain(slot, wait, 1.0f, 1.0f);
+}
+
+int32_t NativeDSP::spawnPitchedGrain(int32_t slot, int32_t wait, float pitch, float amp) {
+    if (freeCount_ == 0 || aliveCount_ >= getMaxOverlap()) {
+        return -1;
+    }
+    invalidateFreezeCache();
+    freeCount_ = freeCount_ - 1;
+    const int32_t index = freeGrains_[freeCount_];
+    grains_[index].slot = slot;
+    grains_[index].wait = wait;
+    grains_[index].pitch = pitch;
+    grains_[index].amp = amp;
+    respawnGrain(index);
+    aliveGrains_[aliveCount_] = index;
+    aliveCount_ = aliveCount_ + 1;
+    return index;
+}
+
+int32_t NativeDSP::spawnNextGrain(int32_t wait) {
+    if (cloudSlotCount_ <= 0) return -1;
+    const int32_t slot = nextSpawnSlot_;
+    const int32_t index = spawnGrain(slot, wait);
+    if (index >= 0) {
+        nextSpawnSlot_ = (slot + 1) % cloudSlotCount_;
+    }
+    return index;
+}
+
+void NativeDSP::retireGrain(int32_t alivePos) {
+    const int32_t index = aliveGrains_[alivePos];
+    const int32_t last = aliveCount_ - 1;
+    aliveGrains_[alivePos] = aliveGrains_[last];
+    aliveCount_ = last;
+    grains_[index].active = 0;
+    grains_[index].wait = 0;
+    freeGrains_[freeCount_] = index;
+    freeCount_ = freeCount_ + 1;
+}
+
+void NativeDSP::distributeGrains(int32_t activeSlotCount) {
+    stopAllGrains();
+    queueCount_ = 0;
+    cloudSlotCount_ = activeSlotCount > 0 ? activeSlotCount : 0;
+    nextSpawnSlot_ = 0;
+}
+
+// ============================================
+// Slots and speed (slot.mbt)
+// ============================================
+
+void NativeDSP::reserveSlots() {
+    while (static_cast<int32_t>(slots_.size()) < MAX_SLOT_COUNT) {
+        ++allocationCount_;
+        slots_.push_back(SlotMeta());
+    }
+}
+
+void NativeDSP::initSlots() {
+    reserveSlots();
+    slotCount_ = 0;
+}
+
+int32_t NativeDSP::loadSampleToSlot(int32_t slot, int32_t dataPtr, int32_t length) {
+    if (slot < 0 || slot >= MAX_SLOT_COUNT) return -1;
+    if (length <= 0) return -2;
+    invalidateFreezeCache();
+    reserveSlots();
+    while (slotCount_ <= slot) {
+        slots_[slotCount_] = SlotMeta();
+        slotCount_ = slotCount_ + 1;
+    }
+    slots_[slot].dataPtr = dataPtr;
+    slots_[slot].length = length;
+    slots_[slot].playPos = 0.0f;
+    slots_[slot].playing = 0;
+    respawnSlotGrains(slot);
+    updateGains();
+    return 0;
+}
+
+int32_t NativeDSP::clearSlotData(int32_t slot) {
+    if (slot < 0 || slot >= slotCount_) return 0;
+    invalidateFreezeCache();
+    slots_[slot] = SlotMeta();
+    return 0;
+}
+
+int32_t NativeDSP::getSlotSampleLength(int32_t slot) const {
+    if (slot < 0 || slot >= slotCount_) return 0;
+    return slots_[slot].length;
+}
+
+int32_t NativeDSP::getSlotDataPtr(int32_t slot) const {
+    if (slot < 0 || slot >= slotCount_) return 0;
+    return slots_[slot].dataPtr;
+}
+
+void NativeDSP::startAllSlots() {
+    for (int32_t i = 0; i < slotCount_; ++i) {
+        if (slots_[i].length > 0) {
+            slots_[i].playPos = 0.0f;
+            slots_[i].playing = 1;
+        }
+    }
+}
+
+void NativeDSP::stopAllSlots() {
+    for (int32_t i = 0; i < slotCount_; ++i) {
+        slots_[i].playing = 0;
+    }
+}
+
+void NativeDSP::applyPlaybackSpeed(float speed) {
+    invalidateFreezeCache();
+    playbackSpeed_ = speed;
+}
+
+void NativeDSP::applyFreeze(bool value) {
+    invalidateFreezeCache();
+    freeze_ = value;
+}
+
+void NativeDSP::applySpeedTarget(float target) {
+    invalidateFreezeCache();
+    targetSpeed_ = target;
+    const float rampTimeSamples = sampleRate_ * SPEED_RAMP_TIME_MS / 1000.0f;
+    if (rampTimeSamples > 0.0f) {
+        speedRampStep_ = (target - currentSpeed_) / rampTimeSamples;
+    } else {
+        currentSpeed_ = target;
+        speedRampStep_ = 0.0f;
+    }
+}
+
+int32_t NativeDSP::planSpeedSegment(int32_t maxLen) {
+    // The lane stopped: back to the setter speed
+    speedFollowsLane_ = false;
+    const float step = speedRampStep_;
+    if (step == 0.0f || maxLen <= 0) {
+        segmentSpeed_ = playbackSpeed_;
+        segmentSpeedStep_ = 0.0f;
+        return maxLen;
+    }
+    const float start = currentSpeed_;
+    // Samples until the per-sample ramp reaches (and clamps to) its target
+    const float remaining = (targetSpeed_ - start) / step;
+    const int32_t whole = toInt(remaining);
+    const int32_t toTarget = static_cast<float>(whole) < remaining ? whole + 1 : whole;
+    segmentSpeed_ = start;
+    if (toTarget <= maxLen) {
+        const int32_t len = toTarget < 1 ? 1 : toTarget;
+        segmentSpeedStep_ = (targetSpeed_ - start) / static_cast<float>(len);
+        currentSpeed_ = targetSpeed_;
+        speedRampStep_ = 0.0f;
+        playbackSpeed_ = currentSpeed_;
+        return len;
+    }
+    segmentSpeedStep_ = step;
+    currentSpeed_ = start + step * static_cast<float>(maxLen);
+    playbackSpeed_ = currentSpeed_;
+    return maxLen;
+}
+
+void NativeDSP::followSpeedSegment(float endSpeed, int32_t len) {
+    const float start = speedFollowsLane_ ? laneSpeed_ : playbackSpeed_;
+    segmentSpeed_ = start;
+    segmentSpeedStep_ = len > 0 ? (endSpeed - start) / static_cast<float>(len) : 0.0f;
+    laneSpeed_ = endSpeed;
+    speedFollowsLane_ = true;
+}
+
+// ============================================
+// Blend gains (blend.mbt)
+// ============================================
+
+void NativeDSP::updateGains() {
+    invalidateFreezeCache();
+    const int32_t slotCount = slotCount_;
+    // Newly covered slots start silent
+    for (int32_t i = gainCount_; i < slotCount; ++i) {
+        gains_[i] = 0.0f;
+        targetGains_[i] = 0.0f;
+        segmentGains_[i] = 0.0f;
+        segmentGainSteps_[i] = 0.0f;
+    }
+    gainCount_ = slotCount;
+    if (slotCount == 0) return;
+
+    computeBlendGains(blendX_, blendY_);
+
+    // When the slot count changes, gains jump to their targets
+    if (slotCount != prevSlotCount_) {
+        for (int32_t i = 0; i < slotCount; ++i) {
+            gains_[i] = targetGains_[i];
+        }
+        prevSlotCount_ = slotCount;
+    }
+}
+
+void NativeDSP::updateSlotGeometry(int32_t slotCount) {
+    if (slotCount == geometrySlotCount_) return;
+    const double twoPi = 2.0 * PI;
+    for (int32_t i = 0; i < slotCount; ++i) {
+        const double angle = twoPi * static_cast<double>(i) / static_cast<double>(slotCount);
+        slotPosX_[i] = static_cast<float>(std::cos(angle));
+        slotPosY_[i] = static_cast<float>(std::sin(angle));
+    }
+    geometryNorm_ = static_cast<float>(std::sqrt(static_cast<double>(slotCount)));
+    geometryEqualGain_ = slotCount > 0 ? 1.0f / geometryNorm_ : 1.0f;
+    geometrySlotCount_ = slotCount;
+}
+
+void NativeDSP::computeBlendGains(float x, float y) {
+    const int32_t slotCount = gainCount_;
+    if (slotCount == 0) return;
+    updateSlotGeometry(slotCount);
+
+    // Weight: closer = higher weight, (2 - dist)^4 for sharp falloff
+    float totalWeight = 0.0f;
+    for (int32_t i = 0; i < slotCount; ++i) {
+        const float dx = x - slotPosX_[i];
+        const float dy = y - slotPosY_[i];
+        const float w = 2.0f - std::sqrt(dx * dx + dy * dy);
+        const float weight = w > 0.0f ? w * w * w * w : 0.0f;
+        blendWeights_[i] = weight;
+        totalWeight = totalWeight + weight;
+    }
+
+    if (totalWeight > 0.0f) {
+        // Normalize weights to sum to √N (preserves perceived loudness)
+        const float scale = geometryNorm_ / totalWeight;
+        for (int32_t i = 0; i < slotCount; ++i) {
+            targetGains_[i] = blendWeights_[i] * scale;
+        }
+    } else {
+        for (int32_t i = 0; i < slotCount; ++i) {
+            targetGains_[i] = geometryEqualGain_;
+        }
+    }
+}
+
+float NativeDSP::gainRampDecay(int32_t len) {
+    if (len <= 0) return 1.0f;
+    const auto& table = gainDecayTable();
+    if (len <= RAMP_SEGMENT_LENGTH) return table[static_cast<size_t>(len)];
+    const float oneMinusCoeff = 1.0f - GAIN_SMOOTH_COEFF;
+    float decay = table[RAMP_SEGMENT_LENGTH];
+    for (int32_t i = RAMP_SEGMENT_LENGTH; i < len; ++i) {
+        decay = decay * oneMinusCoeff;
+    }
+    return decay;
+}
+
+float NativeDSP::gainRampEnd(float start, float target, int32_t len) {
+    return target + (start - target) * gainRampDecay(len);
+}
+
+void NativeDSP::planGainSegment(int32_t len) {
+    if (len <= 0) return;
+    const float invLen = 1.0f / static_cast<float>(len);
+    const float decay = gainRampDecay(len);
+    for (int32_t i = 0; i < gainCount_; ++i) {
+        const float start = gains_[i];
+        const float target = targetGains_[i];
+        const float end = target + (start - target) * decay;
+        segmentGains_[i] = start;
+        segmentGainSteps_[i] = (end - start) * invLen;
+        gains_[i] = end;
+    }
+}
+
+bool NativeDSP::gainsSettled() const {
+    for (int32_t i = 0; i < gainCount_; ++i) {
+        if (gains_[i] != targetGains_[i] || segmentGainSteps_[i] != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NativeDSP::planGainSegmentLinear(int32_t len) {
+    if (len <= 0) return;
+    const float invLen = 1.0f / static_cast<float>(len);
+    for (int32_t i = 0; i < gainCount_; ++i) {
+        const float start = gains_[i];
+        const float end = targetGains_[i];
+        segmentGains_[i] = start;
+        segmentGainSteps_[i] = (end - start) * invLen;
+        gains_[i] = end;
+    }
+}
+
+float NativeDSP::getSegmentGain(int32_t slot) const {
+    if (slot < 0 || slot >= gainCount_) return 0.0f;
+    return segmentGains_[slot];
+}
+
+float NativeDSP::getSegmentGainStep(int32_t slot) const {
+    if (slot < 0 || slot >= gainCount_) return 0.0f;
+    return segmentGainSteps_[slot];
+}
+
+// ============================================
+// Scheduler (scheduler.mbt)
+// ============================================
+
+void NativeDSP::resetScheduler() {
+    sampleClock_ = 0;
+    nextSpawnTime_ = 0.0;
+    allNotesOff();
+    queueCount_ = 0;
+}
+
+double NativeDSP::getSpawnInterval() const {
+    const int32_t overlap = getActiveGrainCount();
+    if (overlap <= 0) return 0.0;
+    const double interval = static_cast<double>(grainLength_) / static_cast<double>(overlap);
+    return interval < 1.0 ? 1.0 : interval;
+}
+
+bool NativeDSP::enqueueStart(int64_t time, int32_t slot, int32_t voice) {
+    if (queueCount_ >= SPAWN_QUEUE_CAPACITY) return false;
+    int32_t i = queueCount_;
+    // Queued after starts at the same time, so those are taken first
+    while (i > 0 && queueTimes_[i - 1] <= time) {
+        queueTimes_[i] = queueTimes_[i - 1];
+        queueSlots_[i] = queueSlots_[i - 1];
+        queueVoices_[i] = queueVoices_[i - 1];
+        i = i - 1;
+    }
+    queueTimes_[i] = time;
+    queueSlots_[i] = slot;
+    queueVoices_[i] = voice;
+    queueCount_ = queueCount_ + 1;
+    return true;
+}
+
+void NativeDSP::scheduleSegment(int32_t len) {
+    const int64_t segStart = sampleClock_;
+    const int64_t segEnd = segStart + len;
+    const double interval = getSpawnInterval();
+    if (interval > 0.0 && !freeze_) {
+        const double startTime = static_cast<double>(segStart);
+        // Catch up after silence and pull in a spawn planned at a lower density
+        if (nextSpawnTime_ < startTime) {
+            nextSpawnTime_ = startTime;
+        } else if (nextSpawnTime_ > startTime + interval) {
+            nextSpawnTime_ = startTime + interval;
+        }
+        const double endTime = static_cast<double>(segEnd);
+        while (nextSpawnTime_ < endTime) {
+            enqueueStart(toInt64(nextSpawnTime_), -1, -1);
+            const float jitter = (randomUnit() * 2.0f - 1.0f) * grainJitter_;
+            const double step = interval * (1.0 + static_cast<double>(jitter));
+            nextSpawnTime_ = nextSpawnTime_ + (step < 1.0 ? 1.0 : step);
+        }
+    }
+    if (!freeze_) {
+        scheduleVoices(static_cast<double>(segStart), static_cast<double>(segEnd));
+    }
+    while (queueCount_ > 0 && queueTimes_[queueCount_ - 1] < segEnd) {
+        const int32_t last = queueCount_ - 1;
+        const int64_t time = queueTimes_[last];
+        const int32_t slot = queueSlots_[last];
+        const int32_t voice = queueVoices_[last];
+        queueCount_ = last;
+        const int32_t wait = time > segStart ? static_cast<int32_t>(time - segStart) : 0;
+        if (voice >= 0) {
+            spawnVoiceGrain(voice, wait);
+        } else if (slot < 0) {
+            spawnNextGrain(wait);
+        } else {
+            spawnGrain(slot, wait);
+        }
+    }
+    sampleClock_ = segEnd;
+}
+
+// ============================================
+// Rendering (render.mbt)
+// ============================================
+
+float NativeDSP::mixNormTarget() const {
+    const int32_t active = getActiveGrainCount();
+    const int32_t targetOverlap = aliveCount_ > active ? aliveCount_ : active;
+    if (targetOverlap > 1) {
+        return 1.0f / std::sqrt(static_cast<float>(targetOverlap));
+    }
+    return 1.0f;
+}
+
+void NativeDSP::renderSegment(int32_t leftOutPtr, int32_t rightOutPtr,
+                              int32_t offset, int32_t len) {
+    for (int32_t j = 0; j < len; ++j) {
+        segmentMix_[j] = 0.0f;
+    }
+    const float speed = segmentSpeed_;
+    const float speedStep = segmentSpeedStep_;
+    // Direction is fixed per segment (taken from its first sample)
+    const bool reverse = speed + speedStep < 0.0f;
+    const int64_t step = speedToPhaseStep(speed);
+    const int64_t stepInc = speedToPhaseStep(speedStep);
+    const int32_t parts = renderPartCount_;
+    int32_t i = 0;
+    while (i < aliveCount_) {
+        const bool alive = (parts == 1 || i % parts == renderPart_)
+            ? renderGrain(aliveGrains_[i], len, reverse, step, stepInc)
+            : skipGrain(aliveGrains_[i], len, step, stepInc);
+        if (alive) {
+            i = i + 1;
+        } else {
+            // Swap-removes, so position i now holds an unvisited grain
+            retireGrain(i);
+        }
+    }
+
+    // Normalize by sqrt of the grain overlap (preserve perceived loudness)
+    const float norm = mixNorm_;
+    const float normEnd = gainRampEnd(norm, mixNormTarget(), len);
+    const float normStep = (normEnd - norm) / static_cast<float>(len);
+    mixNorm_ = normEnd;
+    for (int32_t j = 0; j < len; ++j) {
+        const float out = segmentMix_[j] * (norm + normStep * static_cast<float>(j + 1));
+        const int32_t byteOffset = (offset + j) * FLOAT32_SIZE;
+        storeF32(leftOutPtr + byteOffset, out);
+        storeF32(rightOutPtr + byteOffset, out);
+    }
+}
+
+/** Phase step and its per-sample increment for a grain's pitch */
+static void grainSteps(float pitch, int64_t& step, int64_t& stepInc) {
+    if (pitch == 1.0f) return;
+    const double p = static_cast<double>(pitch);
+    step = toInt64(static_cast<double>(step) * p);
+    stepInc = toInt64(static_cast<double>(stepInc) * p);
+}
+
+bool NativeDSP::renderGrain(int32_t index, int32_t len, bool reverse,
+                            int64_t step, int64_t stepInc) {
+    Grain& grain = grains_[index];
+    const int32_t slot = grain.slot;
+    const int32_t slotLen = getSlotSampleLength(slot);
+    // Grains in emptied slots (or deactivated externally) end immediately
+    if (grain.active == 0 || slotLen <= 0) return false;
+    const int32_t ptr = getSlotDataPtr(slot);
+    // Note voice grains play transposed and at their velocity's amplitude
+    const float gain = getSegmentGain(slot) * grain.amp;
+    const float gainStep = getSegmentGainStep(slot) * grain.amp;
+    grainSteps(grain.pitch, step, stepInc);
+    const bool frozen = freeze_;
+    const int32_t first = grain.wait;
+    grain.wait = 0;
+    for (int32_t j = first; j < len; ++j) {
+        const float sample = readInterpolated(ptr, slotLen, grain.readPosition(reverse));
+        const float envelope = calculateEnvelope(grain.position(), grain.length);
+        const float g = gain + gainStep * static_cast<float>(j + 1);
+        segmentMix_[j] = segmentMix_[j] + sample * envelope * g;
+
+        // Advance by absolute speed (always positive)
+        const int64_t signedStep = step + stepInc * static_cast<int64_t>(j + 1);
+        grain.phase = grain.phase + (signedStep < 0 ? -signedStep : signedStep);
+        if (grain.phase >= grain.endPhase) {
+            if (frozen) {
+                grain.phase = 0;
+            } else {
+                grain.active = 0;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool NativeDSP::skipGrain(int32_t index, int32_t len, int64_t step, int64_t stepInc) {
+    Grain& grain = grains_[index];
+    if (grain.active == 0 || getSlotSampleLength(grain.slot) <= 0) return false;
+    grainSteps(grain.pitch, step, stepInc);
+    const int32_t first = grain.wait;
+    grain.wait = 0;
+    if (first >= len) return true;
+    // The phase advances by |step + stepInc * k| for k = first + 1 .. len;
+    // while that keeps one sign, the sum is the arithmetic series
+    const int64_t firstStep = step + stepInc * static_cast<int64_t>(first + 1);
+    const int64_t lastStep = step + stepInc * static_cast<int64_t>(len);
+    if ((firstStep >= 0 && lastStep >= 0) || (firstStep <= 0 && lastStep <= 0)) {
+        const int64_t total = (firstStep + lastStep) * static_cast<int64_t>(len - first) / 2;
+        const int64_t advance = total < 0 ? -total : total;
+        if (grain.phase + advance < grain.endPhase) {
+            grain.phase += advance;
+            return true;
+        }
+        if (!freeze_) {
+            grain.active = 0;
+            return false;
+        }
+    }
+    // A frozen grain looping back, or the speed crossing zero
+    return skipGrainSamples(grain, first, len, step, stepInc);
+}
+
+bool NativeDSP::skipGrainSamples(Grain& grain, int32_t first, int32_t len, int64_t step,
+                                 int64_t stepInc) {
+    const bool frozen = freeze_;
+    for (int32_t j = first; j < len; ++j) {
+        const int64_t signedStep = step + stepInc * static_cast<int64_t>(j + 1);
+        grain.phase = grain.phase + (signedStep < 0 ? -signedStep : signedStep);
+        if (grain.phase >= grain.endPhase) {
+            if (frozen) {
+                grain.phase = 0;
+            } else {
+                grain.active = 0;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ============================================
+// Modulation lanes (modulation.mbt)
+// ============================================
+
+void NativeDSP::beginModulationBlock(int32_t statePtr, int32_t numSamples) {
+    if (statePtr == 0) {
+        modFlags_ = 0;
+    } else {
+        const int32_t capacity = loadI32(statePtr + 4);
+        const int32_t readOffset = loadI32(statePtr + 12);
+        modFlags_ = (readOffset >= 0 && capacity - readOffset >= numSamples)
+            ? loadI32(statePtr) : 0;
+        modCapacity_ = capacity;
+        modReadOffset_ = readOffset;
+        modLanesPtr_ = statePtr + MOD_HEADER_BYTES;
+    }
+    // Blend modulation ended: head back to the scalar blend position
+    if (blendWasModulated_ && !isBlendModulated()) {
+        computeBlendGains(blendX_, blendY_);
+    }
+    blendWasModulated_ = isBlendModulated();
+}
+
+bool NativeDSP::isBlendModulated() const {
+    return isModulated(MOD_BLEND_X) || isModulated(MOD_BLEND_Y);
+}
+
+float NativeDSP::getModulation(int32_t lane, int32_t index) const {
+    const int32_t sample = lane * modCapacity_ + modReadOffset_ + index;
+    return loadF32(modLanesPtr_ + sample * FLOAT32_SIZE);
+}
+
+int32_t NativeDSP::planSegment(int32_t offset, int32_t maxLen) {
+    int32_t len = maxLen;
+    if (isModulated(MOD_SPEED)) {
+        followSpeedSegment(getModulation(MOD_SPEED, offset + maxLen - 1), maxLen);
+    } else {
+        len = planSpeedSegment(maxLen);
+    }
+    if (isBlendModulated()) {
+        const int32_t last = offset + len - 1;
+        const float x = isModulated(MOD_BLEND_X) ? getModulation(MOD_BLEND_X, last) : blendX_;
+        const float y = isModulated(MOD_BLEND_Y) ? getModulation(MOD_BLEND_Y, last) : blendY_;
+        computeBlendGains(x, y);
+        planGainSegmentLinear(len);
+    } else {
+        planGainSegment(len);
+    }
+    return len;
+}
+
+// ============================================
+// Event list (events.mbt)
+// ============================================
+
+void NativeDSP::beginEventBlock(int32_t statePtr) {
+    eventCursor_ = 0;
+    if (statePtr == 0) {
+        eventCount_ = 0;
+        return;
+    }
+    const int32_t count = loadI32(statePtr + 8);
+    eventCount_ = count < 0 ? 0 : count > MAX_BLOCK_EVENTS ? MAX_BLOCK_EVENTS : count;
+    const int32_t laneBytes = loadI32(statePtr + 4) * FLOAT32_SIZE;
+    eventsPtr_ = statePtr + MOD_HEADER_BYTES + MOD_LANE_COUNT * laneBytes;
+}
+
+void NativeDSP::applyEventsUntil(int32_t offset) {
+    while (eventCursor_ < eventCount_ &&
+           loadI32(eventsPtr_ + eventCursor_ * EVENT_RECORD_BYTES) <= offset) {
+        const int32_t record = eventsPtr_ + eventCursor_ * EVENT_RECORD_BYTES;
+        applyEvent(loadI32(record + 4), loadF32(record + 8), loadI32(record + 12));
+        eventCursor_ = eventCursor_ + 1;
+    }
+}
+
+int32_t NativeDSP::nextEventOffset(int32_t blockEnd) const {
+    if (eventCursor_ < eventCount_) {
+        const int32_t offset = loadI32(eventsPtr_ + eventCursor_ * EVENT_RECORD_BYTES);
+        return offset < blockEnd ? offset : blockEnd;
+    }
+    return blockEnd;
+}
+
+void NativeDSP::applyEvent(int32_t type, float value, int32_t data) {
+    // Event types match suna::EventType; unknown types are ignored
+    switch (type) {
+        case 0: setBlendX(value); break;
+        case 1: setBlendY(value); break;
+        case 2: applyPlaybackSpeed(value); break;
+        case 3: applySpeedTarget(value); break;
+        case 4: setGrainLength(toInt(value)); break;
+        case 5: setGrainDensity(value); break;
+        case 6: applyFreeze(value != 0.0f); break;
+        case 7: setInterpolation(toInt(value)); break;
+        case 8: setGrainJitter(value); break;
+        case 9: setMaxOverlap(toInt(value)); break;
+        case 10: startAllSlots(); break;
+        case 11: stopAllSlots(); break;
+        case 12: noteOn(data, value); break;
+        case 13: noteOff(data); break;
+        case 14: allNotesOff(); break;
+        case 15: {
+            const int32_t mode = toInt(value);
+            if (mode == NOTE_MODE_PITCH || mode == NOTE_MODE_SLOT) {
+                noteMode_ = mode;
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+// ============================================
+// Note voices (voices.mbt)
+// ============================================
+
+void NativeDSP::noteOn(int32_t note, float velocity) {
+    if (velocity <= 0.0f) {
+        noteOff(note);
+        return;
+    }
+    int32_t voice = -1;
+    for (int32_t i = 0; i < MAX_VOICES; ++i) {
+        if (voiceNote_[i] == note) {
+            voice = i;
+            break;
+        }
+    }
+    if (voice < 0) {
+        for (int32_t i = 0; i < MAX_VOICES; ++i) {
+            if (voiceNote_[i] < 0) {
+                voice = i;
+                break;
+            }
+        }
+    }
+    if (voice < 0) {
+        voice = 0;
+        for (int32_t i = 1; i < MAX_VOICES; ++i) {
+            if (voiceAge_[i] < voiceAge_[voice]) {
+                voice = i;
+            }
+        }
+    }
+    voiceNote_[voice] = note;
+    voiceVelocity_[voice] = velocity > 1.0f ? 1.0f : velocity;
+    voiceAge_[voice] = voiceCounter_;
+    voiceCounter_ = voiceCounter_ + 1;
+    // First grain starts on the note's own sample
+    voiceNextSpawn_[voice] = static_cast<double>(sampleClock_);
+    voiceNextSlot_[voice] = 0;
+}
+
+void NativeDSP::noteOff(int32_t note) {
+    for (int32_t i = 0; i < MAX_VOICES; ++i) {
+        if (voiceNote_[i] == note) {
+            voiceNote_[i] = -1;
+        }
+    }
+}
+
+void NativeDSP::allNotesOff() {
+    voiceNote_.fill(-1);
+}
+
+float NativeDSP::notePitchRatio(int32_t note) const {
+    if (noteMode_ == NOTE_MODE_SLOT) return 1.0f;
+    return static_cast<float>(std::pow(2.0, static_cast<double>(note - ROOT_NOTE) / 12.0));
+}
+
+int32_t NativeDSP::velocityToOverlap(float velocity) const {
+    const int32_t share = getMaxOverlap() / MAX_VOICES;
+    if (share <= 1) return 1;
+    return 1 + toInt(static_cast<float>(share - 1) * velocity);
+}
+
+int32_t NativeDSP::voiceSlot(int32_t voice) {
+    const int32_t slots = cloudSlotCount_;
+    if (slots <= 0) return -1;
+    if (noteMode_ == NOTE_MODE_SLOT) {
+        const int32_t index = (voiceNote_[voice] - ROOT_NOTE) % slots;
+        return index < 0 ? index + slots : index;
+    }
+    const int32_t slot = voiceNextSlot_[voice] % slots;
+    voiceNextSlot_[voice] = (slot + 1) % slots;
+    return slot;
+}
+
+int32_t NativeDSP::spawnVoiceGrain(int32_t voice, int32_t wait) {
+    // Released (or stolen for another note) since the start was queued
+    if (voiceNote_[voice] < 0) return -1;
+    const int32_t slot = voiceSlot(voice);
+    if (slot < 0) return -1;
+    const float velocity = voiceVelocity_[voice];
+    return spawnPitchedGrain(slot, wait, notePitchRatio(voiceNote_[voice]), velocity * velocity);
+}
+
+void NativeDSP::scheduleVoices(double startTime, double endTime) {
+    const double length = static_cast<double>(grainLength_);
+    for (int32_t v = 0; v < MAX_VOICES; ++v) {
+        if (voiceNote_[v] < 0) continue;
+        const double interval = length /
+            static_cast<double>(velocityToOverlap(voiceVelocity_[v]));
+        if (voiceNextSpawn_[v] < startTime) {
+            voiceNextSpawn_[v] = startTime;
+        }
+        while (voiceNextSpawn_[v] < endTime) {
+            enqueueStart(toInt64(voiceNextSpawn_[v]), -1, v);
+            const float jitter = (randomUnit() * 2.0f - 1.0f) * grainJitter_;
+            const double step = interval * (1.0 + static_cast<double>(jitter));
+            voiceNextSpawn_[v] = voiceNextSpawn_[v] + (step < 1.0 ? 1.0 : step);
+        }
+    }
+}
+
+// ============================================
+// Live input capture ring (capture.mbt)
+// ============================================
+
+int32_t NativeDSP::setLiveInputSlot(int32_t slot) {
+    if (slot < -1 || slot >= MAX_SLOT_COUNT) return -1;
+    const int32_t previous = liveInputSlot_;
+    liveInputSlot_ = slot;
+    if (previous >= 0 && previous != slot) {
+        clearSlotData(previous);
+    }
+    if (slot >= 0) {
+        loadSampleToSlot(slot, CAPTURE_RING_PTR, 2 * CAPTURE_CAPACITY);
+    }
+    return 0;
+}
+
+void NativeDSP::captureInput(int32_t leftPtr, int32_t rightPtr, int32_t offset, int32_t len) {
+    if (liveInputSlot_ < 0) return;
+    int32_t write = captureWrite_;
+    for (int32_t i = 0; i < len; ++i) {
+        const int32_t byte = (offset + i) * FLOAT32_SIZE;
+        const float sample = (loadF32(leftPtr + byte) + loadF32(rightPtr + byte)) * 0.5f;
+        const int32_t ptr = CAPTURE_RING_PTR + write * FLOAT32_SIZE;
+        storeF32(ptr, sample);
+        storeF32(ptr + CAPTURE_CAPACITY * FLOAT32_SIZE, sample);
+        write = write + 1;
+        if (write == CAPTURE_CAPACITY) {
+            write = 0;
+        }
+    }
+    captureWrite_ = write;
+}
+
+static int32_t liveGrainDuration(int32_t length, float speed) {
+    const float magnitude = speed < 0.0f ? -speed : speed;
+    if (magnitude >= 1.0f) return length;
+    const float duration = static_cast<float>(length) / magnitude;
+    if (duration >= static_cast<float>(CAPTURE_CAPACITY)) return CAPTURE_CAPACITY;
+    return toInt(duration) + 1;
+}
+
+int32_t NativeDSP::liveGrainStart(int32_t length, float speed) {
+    int32_t delay = captureDelay_;
+    if (captureWindow_ > 0) {
+        delay = delay + randomRange(0, captureWindow_ + 1);
+    }
+    const int32_t maxDelay = CAPTURE_CAPACITY - liveGrainDuration(length, speed);
+    if (delay > maxDelay) {
+        delay = maxDelay;
+    }
+    if (delay < length) {
+        delay = length;
+    }
+    const int32_t start = captureWrite_ - delay;
+    return start < 0 ? start + CAPTURE_CAPACITY : start;
+}
+
+// ============================================
+// Freeze loop cache (freeze_cache.mbt)
+// ============================================
+
+static int32_t frozenGrainPeriod(int64_t endPhase, int64_t step) {
+    if (step <= 0) return 0;
+    return static_cast<int32_t>((endPhase + step - 1) / step);
+}
+
+int64_t NativeDSP::segmentPhaseStep() const {
+    const int64_t step = speedToPhaseStep(segmentSpeed_);
+    return step < 0 ? -step : step;
+}
+
+bool NativeDSP::freezeMixSettled() const {
+    return freeze_ && segmentSpeedStep_ == 0.0f && gainsSettled() &&
+           mixNorm_ == mixNormTarget();
+}
+
+int32_t NativeDSP::frozenCloudPeriod(int64_t step) const {
+    if (aliveCount_ == 0 || queueCount_ > 0) return 0;
+    const int64_t endPhase = grains_[aliveGrains_[0]].endPhase;
+    for (int32_t i = 0; i < aliveCount_; ++i) {
+        const Grain& grain = grains_[aliveGrains_[i]];
+        // Transposed grains loop with a period of their own, and live input
+        // grains replay a ring that keeps changing
+        if (grain.endPhase != endPhase || grain.wait > 0 || grain.pitch != 1.0f ||
+            isLiveInputSlot(grain.slot)) {
+            return 0;
+        }
+    }
+    return frozenGrainPeriod(endPhase, step);
+}
+
+int32_t NativeDSP::frozenCloudSettleTime(int64_t step) const {
+    int32_t longest = 0;
+    for (int32_t i = 0; i < aliveCount_; ++i) {
+        const Grain& grain = grains_[aliveGrains_[i]];
+        if (grain.phase % step != 0) {
+            const int32_t toWrap = frozenGrainPeriod(grain.endPhase - grain.phase, step);
+            if (toWrap > longest) {
+                longest = toWrap;
+            }
+        }
+    }
+    return longest;
+}
+
+void NativeDSP::advanceFrozenGrains(int32_t count, int64_t step, int32_t period) {
+    if (step <= 0 || period <= 0) return;
+    const int64_t shift = count % period;
+    const int64_t loopLen = period;
+    for (int32_t i = 0; i < aliveCount_; ++i) {
+        Grain& grain = grains_[aliveGrains_[i]];
+        grain.phase = (grain.phase / step + shift) % loopLen * step;
+    }
+}
+
+void NativeDSP::invalidateFreezeCache() {
+    if (freezeCacheState_ == CACHE_PLAYING) {
+        const int32_t period = freezeCachePeriod_;
+        const int32_t elapsed = freezeCachePos_ - freezeCacheBase_ + period;
+        advanceFrozenGrains(elapsed, freezeCacheStep_, period);
+    }
+    freezeCacheState_ = CACHE_IDLE;
+}
+
+void NativeDSP::beginFreezeCache(int64_t step) {
+    freezeCacheState_ = CACHE_IDLE;
+    const int32_t period = frozenCloudPeriod(step);
+    if (period <= 0 || period > FREEZE_CACHE_CAPACITY) return;
+    freezeCachePeriod_ = period;
+    freezeCacheSpeed_ = segmentSpeed_;
+    freezeCacheStep_ = step;
+    freezeCacheWait_ = frozenCloudSettleTime(step);
+    freezeCachePos_ = 0;
+    freezeCacheState_ = freezeCacheWait_ > 0 ? CACHE_PRIMING : CACHE_RECORDING;
+}
+
+void NativeDSP::recordFreezeCache(int32_t outPtr, int32_t offset, int32_t len) {
+    if (!freezeMixSettled()) {
+        freezeCacheState_ = CACHE_IDLE;
+        return;
+    }
+    if (freezeCacheState_ == CACHE_IDLE || segmentSpeed_ != freezeCacheSpeed_) {
+        beginFreezeCache(segmentPhaseStep());
+        return;
+    }
+    if (freezeCacheState_ == CACHE_PRIMING) {
+        freezeCacheWait_ = freezeCacheWait_ - len;
+        if (freezeCacheWait_ <= 0) {
+            freezeCachePos_ = 0;
+            freezeCacheState_ = CACHE_RECORDING;
+        }
+        return;
+    }
+    const int32_t period = freezeCachePeriod_;
+    const int32_t remaining = period - freezeCachePos_;
+    const int32_t count = len < remaining ? len : remaining;
+    for (int32_t j = 0; j < count; ++j) {
+        const float value = loadF32(outPtr + (offset + j) * FLOAT32_SIZE);
+        storeF32(FREEZE_CACHE_PTR + (freezeCachePos_ + j) * FLOAT32_SIZE, value);
+    }
+    freezeCachePos_ = freezeCachePos_ + count;
+    if (freezeCachePos_ == period) {
+        // Samples past the period were rendered live; playback continues there
+        freezeCachePos_ = len - count;
+        freezeCacheBase_ = freezeCachePos_;
+        freezeCacheState_ = CACHE_PLAYING;
+    }
+}
+
+bool NativeDSP::playFreezeCache(int32_t leftOutPtr, int32_t rightOutPtr,
+                                int32_t offset, int32_t len) {
+    if (freezeCacheState_ != CACHE_PLAYING) return false;
+    if (!freezeMixSettled() || segmentSpeed_ != freezeCacheSpeed_) {
+        invalidateFreezeCache();
+        return false;
+    }
+    const int32_t period = freezeCachePeriod_;
+    int32_t pos = freezeCachePos_;
+    for (int32_t j = 0; j < len; ++j) {
+        const float out = loadF32(FREEZE_CACHE_PTR + pos * FLOAT32_SIZE);
+        const int32_t byteOffset = (offset + j) * FLOAT32_SIZE;
+        storeF32(leftOutPtr + byteOffset, out);
+        storeF32(rightOutPtr + byteOffset, out);
+        pos = pos + 1;
+        if (pos == period) {
+            pos = 0;
+        }
+    }
+    freezeCachePos_ = pos;
+    return true;
+}
+
+// ============================================
+// Sample readers (interp.mbt)
+// ============================================
+
+float NativeDSP::loadClamped(int32_t ptr, int32_t slotLen, int32_t index) const {
+    const int32_t i = index < 0 ? 0 : index >= slotLen ? slotLen - 1 : index;
+    return loadF32(ptr + i * FLOAT32_SIZE);
+}
+
+float NativeDSP::readInterpolated(int32_t ptr, int32_t slotLen, int64_t pos) const {
+    const int32_t index = static_cast<int32_t>(pos >> PHASE_FRAC_BITS);
+    const int64_t frac = pos & PHASE_FRAC_MASK;
+    const int32_t mode = interpMode_;
+    // Sinc lowpasses integral positions too, so only it reads the table there
+    if (mode == INTERP_NEAREST || (frac == 0 && mode != INTERP_SINC)) {
+        return loadF32(ptr + index * FLOAT32_SIZE);
+    }
+    if (mode == INTERP_LINEAR) {
+        return readLinear(ptr, slotLen, index, frac);
+    }
+    if (mode == INTERP_HERMITE) {
+        return readHermite(ptr, slotLen, index, frac);
+    }
+    return readSinc(ptr, slotLen, index, frac);
+}
+
+float NativeDSP::readLinear(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const {
+    const float t = static_cast<float>(static_cast<double>(frac) / static_cast<double>(PHASE_ONE));
+    const float a = loadF32(ptr + index * FLOAT32_SIZE);
+    const float b = index + 1 < slotLen ? loadF32(ptr + (index + 1) * FLOAT32_SIZE) : a;
+    return a + (b - a) * t;
+}
+
+float NativeDSP::readHermite(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const {
+    const int32_t row = static_cast<int32_t>(frac >> INTERP_TABLE_SHIFT) * 4;
+    const float* c = hermiteTable().data();
+    if (index >= 1 && index + 2 < slotLen) {
+        const int32_t p = ptr + (index - 1) * FLOAT32_SIZE;
+        const float a = c[row] * loadF32(p) + c[row + 1] * loadF32(p + FLOAT32_SIZE);
+        const float b = c[row + 2] * loadF32(p + 2 * FLOAT32_SIZE) +
+                        c[row + 3] * loadF32(p + 3 * FLOAT32_SIZE);
+        return a + b;
+    }
+    const float a = c[row] * loadClamped(ptr, slotLen, index - 1) +
+                    c[row + 1] * loadClamped(ptr, slotLen, index);
+    const float b = c[row + 2] * loadClamped(ptr, slotLen, index + 1) +
+                    c[row + 3] * loadClamped(ptr, slotLen, index + 2);
+    return a + b;
+}
+
+float NativeDSP::readSinc(int32_t ptr, int32_t slotLen, int32_t index, int64_t frac) const {
+    const int32_t row = static_cast<int32_t>(frac >> INTERP_TABLE_SHIFT) * SINC_TAPS;
+    const float* c = sincTable().data();
+    const int32_t first = index - SINC_TAPS / 2 + 1;
+    float acc = 0.0f;
+    if (first >= 0 && first + SINC_TAPS <= slotLen) {
+        const int32_t p = ptr + first * FLOAT32_SIZE;
+        for (int32_t k = 0; k < SINC_TAPS; ++k) {
+            acc = acc + c[row + k] * loadF32(p + k * FLOAT32_SIZE);
+        }
+    } else {
+        for (int32_t k = 0; k < SINC_TAPS; ++k) {
+            acc = acc + c[row + k] * loadClamped(ptr, slotLen, first + k);
+        }
+    }
+    return acc;
+}
+
+// ============================================
+// NativeBackend
+// ============================================
+
+std::unique_ptr<NativeBackend> NativeBackend::create(std::string& error) {
+    std::unique_ptr<NativeBackend> backend(new NativeBackend());
+    if (!backend->dsp_.getMemory()) {
+        error = "linear memory allocation failed";
+        return nullptr;
+    }
+    return backend;
+}
+
+bool NativeBackend::call(DspExport function, uint32_t numArgs, wasm_val_t* args,
+                         int32_t* result) {
+    // Arguments are checked like a WASM signature mismatch would be
+    static constexpr uint32_t ARG_COUNTS[] = {
+        2, 3, 1, 0, 0, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 0
+    };
+    static_assert(sizeof(ARG_COUNTS) / sizeof(ARG_COUNTS[0]) ==
+                  static_cast<size_t>(DspExport::Count), "one count per DspExport");
+    const int index = static_cast<int>(function);
+    if (index < 0 || index >= static_cast<int>(DspExport::Count) || numArgs != ARG_COUNTS[index]) {
+        exception_ = "invalid export call";
+        return false;
+    }
+    exception_ = nullptr;
+
+    auto i32 = [args](int i) { return args[i].of.i32; };
+    auto f32 = [args](int i) { return args[i].of.f32; };
+    int32_t value = 0;
+    switch (function) {
+        case DspExport::InitSampler: value = dsp_.initSampler(f32(0), i32(1)); break;
+        case DspExport::LoadSample: value = dsp_.loadSample(i32(0), i32(1), i32(2)); break;
+        case DspExport::ClearSlot: value = dsp_.clearSlot(i32(0)); break;
+        case DspExport::PlayAll: value = dsp_.playAll(); break;
+        case DspExport::StopAll: value = dsp_.stopAll(); break;
+        case DspExport::GetSlotLength: value = dsp_.getSlotLength(i32(0)); break;
+        case DspExport::ProcessBlock:
+            value = dsp_.processBlock(i32(0), i32(1), i32(2), i32(3), i32(4), i32(5));
+            break;
+        case DspExport::SetBlendX: value = dsp_.setBlendX(f32(0)); break;
+        case DspExport::SetBlendY: value = dsp_.setBlendY(f32(0)); break;
+        case DspExport::SetPlaybackSpeed: value = dsp_.setPlaybackSpeed(f32(0)); break;
+        case DspExport::SetGrainLength: value = dsp_.setGrainLength(i32(0)); break;
+        case DspExport::SetGrainDensity: value = dsp_.setGrainDensity(f32(0)); break;
+        case DspExport::SetFreeze: value = dsp_.setFreeze(i32(0)); break;
+        case DspExport::SetSpeedTarget: value = dsp_.setSpeedTarget(f32(0)); break;
+        case DspExport::SetInterpolation: value = dsp_.setInterpolation(i32(0)); break;
+        case DspExport::SetGrainJitter: value = dsp_.setGrainJitter(f32(0)); break;
+        case DspExport::SetMaxOverlap: value = dsp_.setMaxOverlap(i32(0)); break;
+        case DspExport::SetRenderPartition: value = dsp_.setRenderPartition(i32(0), i32(1)); break;
+        case DspExport::SetLiveInput: value = dsp_.setLiveInput(i32(0)); break;
+        case DspExport::SetCaptureDelay: value = dsp_.setCaptureDelay(i32(0)); break;
+        case DspExport::SetCaptureWindow: value = dsp_.setCaptureWindow(i32(0)); break;
+        case DspExport::GetAllocationCount: value = dsp_.getAllocationCount(); break;
+        case DspExport::Count: break;
+    }
+    if (result) {
+        *result = value;
+    }
+    return true;
+}
+
+} // namespace suna
@@ -1,4 +1,5 @@
 #include "PluginEditor.h"
+#include "suna/Trace.h"
 
 #if !JUCE_DEBUG
 #include "UIBinaryData.h"
@@ -42,7 +43,12 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                 double sampleRate = static_cast<double>(params[2]);
 
                 juce::MemoryOutputStream decoded;
-                if (!juce::Base64::convertFromBase64(decoded, base64PCM)) {
+                bool decodedOk;
+                {
+                  suna::TraceSpan decodeSpan("decode_sample");
+                  decodedOk = juce::Base64::convertFromBase64(decoded, base64PCM);
+                }
+                if (!decodedOk) {
                   juce::Logger::writeToLog("loadSample: Base64 decode failed");
                   complete({});
                   return;
@@ -61,6 +67,23 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                     " samples into slot " + juce::String(slot));
                 complete(juce::var(true));
               })
+          .withNativeFunction(
+              "writeTrace",
+              [](const auto &, auto complete) {
+                // Saves the span timeline (recording with SUNA_TRACE=1) to
+                // the Desktop; returns the path, or nothing on failure
+                auto file = juce::File::getSpecialLocation(
+                                juce::File::userDesktopDirectory)
+                                .getChildFile("suna_trace.json");
+                std::string error;
+                if (!suna::Trace::writeChromeTrace(
+                        file.getFullPathName().toStdString(), error)) {
+                  juce::Logger::writeToLog("writeTrace: " + juce::String(error));
+                  complete({});
+                  return;
+                }
+                complete(juce::var(file.getFullPathName()));
+              })
           .withNativeFunction("clearSlot",
                               [this](const auto &params, auto complete) {
                                 // Expected params from JS: [slot]
@@ -73,6 +96,41 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 audioProcessor.getWasmDSP().clearSlot(slot);
                                 complete(juce::var(true));
                               })
+          .withNativeFunction("setLiveInput",
+                              [this](const auto &params, auto complete) {
+                                // Expected params from JS: [slot] (-1 = off)
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                int slot = static_cast<int>(params[0]);
+                                audioProcessor.getWasmDSP().setLiveInput(slot);
+                                complete(juce::var(
+                                    audioProcessor.getWasmDSP().getLiveInputSlot()));
+                              })
+          .withNativeFunction("setCaptureDelay",
+                              [this](const auto &params, auto complete) {
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                int samples = static_cast<int>(params[0]);
+                                audioProcessor.getWasmDSP().setCaptureDelay(samples);
+                                complete(juce::var(true));
+                              })
+          .withNativeFunction("setCaptureWindow",
+                              [this](const auto &params, auto complete) {
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                int samples = static_cast<int>(params[0]);
+                                audioProcessor.getWasmDSP().setCaptureWindow(samples);
+                                complete(juce::var(true));
+                              })
           .withNativeFunction("playAll",
                               [this](const auto &params, auto complete) {
                                 audioProcessor.getWasmDSP().playAll();
@@ -91,7 +149,7 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 float value = static_cast<float>(params[0]);
-                                audioProcessor.getWasmDSP().setBlendX(value);
+                                setParameterFromUi("blendX", value);
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setBlendY",
@@ -102,7 +160,7 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 float value = static_cast<float>(params[0]);
-                                audioProcessor.getWasmDSP().setBlendY(value);
+                                setParameterFromUi("blendY", value);
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setPlaybackSpeed",
@@ -113,8 +171,7 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 float speed = static_cast<float>(params[0]);
-                                audioProcessor.getWasmDSP().setPlaybackSpeed(
-                                    speed);
+                                setParameterFromUi("playbackSpeed", speed);
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setGrainLength",
@@ -125,8 +182,8 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 int length = static_cast<int>(params[0]);
-                                audioProcessor.getWasmDSP().setGrainLength(
-                                    length);
+                                setParameterFromUi("grainLength",
+                                                   static_cast<float>(length));
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setGrainDensity",
@@ -137,8 +194,7 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 float density = static_cast<float>(params[0]);
-                                audioProcessor.getWasmDSP().setGrainDensity(
-                                    density);
+                                setParameterFromUi("grainDensity", density);
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setFreeze",
@@ -149,7 +205,8 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 int value = static_cast<int>(params[0]);
-                                audioProcessor.getWasmDSP().setFreeze(value);
+                                setParameterFromUi("freeze",
+                                                   static_cast<float>(value));
                                 complete(juce::var(true));
                               })
           .withNativeFunction("setSpeedTarget",
@@ -160,8 +217,47 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
                                 }
 
                                 float target = static_cast<float>(params[0]);
-                                audioProcessor.getWasmDSP().setSpeedTarget(target);
-                                complete(juce::var(true));
+                                const bool posted = audioProcessor.getWasmDSP().postEvent(
+                                    suna::EventType::SpeedTarget, target);
+                                complete(juce::var(posted));
+                              })
+          .withNativeFunction("setInterpolation",
+                              [this](const auto &params, auto complete) {
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                int mode = static_cast<int>(params[0]);
+                                const bool posted = audioProcessor.getWasmDSP().postEvent(
+                                    suna::EventType::Interpolation,
+                                    static_cast<float>(mode));
+                                complete(juce::var(posted));
+                              })
+          .withNativeFunction("setGrainJitter",
+                              [this](const auto &params, auto complete) {
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                float amount = static_cast<float>(params[0]);
+                                const bool posted = audioProcessor.getWasmDSP().postEvent(
+                                    suna::EventType::GrainJitter, amount);
+                                complete(juce::var(posted));
+                              })
+          .withNativeFunction("setMaxOverlap",
+                              [this](const auto &params, auto complete) {
+                                if (params.size() < 1) {
+                                  complete({});
+                                  return;
+                                }
+
+                                int count = static_cast<int>(params[0]);
+                                const bool posted = audioProcessor.getWasmDSP().postEvent(
+                                    suna::EventType::MaxOverlap,
+                                    static_cast<float>(count));
+                                complete(juce::var(posted));
                               }));
 
   addAndMakeVisible(*browser);
@@ -198,15 +294,26 @@ SunaAudioProcessorEditor::SunaAudioProcessorEditor(SunaAudioProcessor &p)
   setSize(662, 862);
   setResizable(true, true);
 
+  startTimerHz(LOAD_METER_HZ);
+
   juce::Logger::writeToLog("SunaAudioProcessorEditor: Constructor complete");
 }
 
 SunaAudioProcessorEditor::~SunaAudioProcessorEditor() {
   juce::Logger::writeToLog("~SunaAudioProcessorEditor: Destructor started");
+  stopTimer();
   browser.reset();
   juce::Logger::writeToLog("~SunaAudioProcessorEditor: Destructor complete");
 }
 
+void SunaAudioProcessorEditor::setParameterFromUi(const juce::String &id,
+                                                  float value) {
+  // The processor forwards the change to the DSP once, like automation
+  if (auto *param = audioProcessor.getParameters().getParameter(id)) {
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+  }
+}
+
 void SunaAudioProcessorEditor::paint(juce::Graphics &g) {
   g.fillAll(juce::Colours::black);
 }
@@ -232,6 +339,38 @@ SunaAudioProcessorEditor::getResource(const juce::String &url) {
 #endif
 }
 
+void SunaAudioProcessorEditor::timerCallback() {
+  // DSP load snapshot: loads are fractions of the block duration
+  auto &dsp = audioProcessor.getWasmDSP();
+  const auto load = dsp.getLoadMeter().snapshot();
+  const auto stats = dsp.getStats();
+
+  juce::Array<juce::var> histogram;
+  for (auto count : load.histogram)
+    histogram.add(static_cast<juce::int64>(count));
+
+  auto *object = new juce::DynamicObject();
+  object->setProperty("load", load.lastLoad);
+  object->setProperty("average", load.averageLoad);
+  object->setProperty("peak", load.peakLoad);
+  object->setProperty("max", load.maxLoad);
+  object->setProperty("blocks", static_cast<juce::int64>(load.blocks));
+  object->setProperty("xrunRisk", static_cast<juce::int64>(load.xrunRisk));
+  object->setProperty("overruns", static_cast<juce::int64>(load.overruns));
+  object->setProperty("histogram", histogram);
+
+  auto *dropped = new juce::DynamicObject();
+  for (int i = 0; i < static_cast<int>(suna::DropReason::Count); ++i) {
+    const auto reason = static_cast<suna::DropReason>(i);
+    dropped->setProperty(suna::getDropReasonName(reason),
+                         static_cast<juce::int64>(stats.getDropped(reason)));
+  }
+  object->setProperty("dropped", juce::var(dropped));
+  object->setProperty("droppedTotal",
+                      static_cast<juce::int64>(stats.getTotalDropped()));
+  browser->emitEventIfBrowserIsVisible("dspLoad", juce::var(object));
+}
+
 void SunaAudioProcessorEditor::grabWebViewFocusIfSafe() {
   if (auto *window = getTopLevelComponent()) {
     bool isActive = window->isOnDesktop() &&
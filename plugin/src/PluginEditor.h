@@ -3,7 +3,8 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
-class SunaAudioProcessorEditor : public juce::AudioProcessorEditor {
+class SunaAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                 private juce::Timer {
 public:
     SunaAudioProcessorEditor(SunaAudioProcessor&);
     ~SunaAudioProcessorEditor() override;
@@ -15,7 +16,12 @@ public:
     void parentHierarchyChanged() override;
     void mouseDown(const juce::MouseEvent&) override;
 
+    /** Rate of the "dspLoad" snapshots sent to the WebView */
+    static constexpr int LOAD_METER_HZ = 15;
+
 private:
+    void timerCallback() override;
+
     SunaAudioProcessor& audioProcessor;
     
     std::unique_ptr<juce::WebBrowserComponent> browser;
@@ -37,6 +43,8 @@ private:
     std::unique_ptr<juce::WebToggleButtonParameterAttachment> freezeAttachment_;
     
     std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
+    /** Set a host parameter from a native function (scaled value) */
+    void setParameterFromUi(const juce::String& id, float value);
     void grabWebViewFocusIfSafe();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SunaAudioProcessorEditor)
@@ -1,9 +1,13 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "SunaBinaryData.h"
+#include "suna/RtCheck.h"
+#include "suna/Trace.h"
+#include <cstdlib>
 
 SunaAudioProcessor::SunaAudioProcessor()
     : AudioProcessor(BusesProperties()
+                         .withInput("Input", juce::AudioChannelSet::stereo(), true)
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       parameters_(*this, nullptr, "Parameters", createParameterLayout())
 {
@@ -24,13 +28,31 @@ SunaAudioProcessor::SunaAudioProcessor()
     grainDensityParam_ = parameters_.getRawParameterValue("grainDensity");
     freezeParam_ = parameters_.getRawParameterValue("freeze");
     
+    suna::DspBackendType backend = suna::DspBackendType::WamrAot;
+#if SUNA_DSP_BACKEND_SWITCH
+    // SUNA_DSP_BACKEND=native runs the native C++ engine instead of the AOT
+    // module (for A/B comparisons in a host); anything else keeps WAMR
+    if (const char* backendName = std::getenv("SUNA_DSP_BACKEND")) {
+        suna::parseBackendName(backendName, backend);
+    }
+#endif
+
+    // SUNA_TRACE=1 records a span timeline from the start (the editor's
+    // writeTrace function saves it)
+    if (const char* trace = std::getenv("SUNA_TRACE"); trace && *trace && *trace != '0') {
+        suna::Trace::start();
+    }
+
     dspInitialized_ = wasmDSP_.initialize(
         reinterpret_cast<const uint8_t*>(SunaBinaryData::suna_dsp_aot),
-        SunaBinaryData::suna_dsp_aotSize
+        SunaBinaryData::suna_dsp_aotSize,
+        1,
+        backend
     );
 
     juce::Logger::writeToLog("SunaAudioProcessor: WasmDSP initialized: " + 
-        juce::String(dspInitialized_ ? "SUCCESS" : "FAILED"));
+        juce::String(dspInitialized_ ? "SUCCESS" : "FAILED") + " (" +
+        suna::getBackendName(backend) + " backend)");
 }
 
 SunaAudioProcessor::~SunaAudioProcessor()
@@ -45,31 +67,72 @@ void SunaAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
         juce::String(sampleRate) + ", blockSize: " + juce::String(samplesPerBlock));
     
     if (dspInitialized_) {
+        // Hosts switch to non-realtime before preparing an offline render
+        wasmDSP_.setNonRealtime(isNonRealtime());
         wasmDSP_.prepareToPlay(sampleRate, samplesPerBlock);
     }
+
+    // Only changes made from here on (automation, host or web UI) are
+    // forwarded; this is the one path host parameters reach the DSP by
+    sentParamValues_ = { blendXParam_->load(), blendYParam_->load(),
+                         playbackSpeedParam_->load(), grainLengthParam_->load(),
+                         grainDensityParam_->load(), freezeParam_->load() };
 }
 
-void SunaAudioProcessor::releaseResources()
+void SunaAudioProcessor::queueParameterChanges()
 {
+    const std::array<std::pair<std::atomic<float>*, suna::EventType>, 6> params = {{
+        { blendXParam_, suna::EventType::BlendX },
+        { blendYParam_, suna::EventType::BlendY },
+        { playbackSpeedParam_, suna::EventType::PlaybackSpeed },
+        { grainLengthParam_, suna::EventType::GrainLength },
+        { grainDensityParam_, suna::EventType::GrainDensity },
+        { freezeParam_, suna::EventType::Freeze },
+    }};
+    for (size_t i = 0; i < params.size(); ++i) {
+        const float value = params[i].first->load();
+        if (value != sentParamValues_[i]) {
+            wasmDSP_.queueEvent(0, params[i].second, value);
+            sentParamValues_[i] = value;
+        }
+    }
 }
 
-void SunaAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void SunaAudioProcessor::queueMidiEvents(const juce::MidiBuffer& midi, int numSamples)
 {
-    static bool firstCall = true;
-    static int paramLogCounter = 0;
-    if (firstCall) {
-        juce::Logger::writeToLog("SunaAudioProcessor::processBlock - First call with " + 
-            juce::String(buffer.getNumSamples()) + " samples");
-        firstCall = false;
+    juce::ignoreUnused(numSamples);
+    // Offsets past the block are clamped when the event list is written
+    for (const auto metadata : midi) {
+        const auto message = metadata.getMessage();
+        const int offset = metadata.samplePosition;
+        if (message.isNoteOn()) {
+            wasmDSP_.queueEvent(offset, suna::EventType::NoteOn,
+                                message.getFloatVelocity(), message.getNoteNumber());
+        } else if (message.isNoteOff()) {
+            wasmDSP_.queueEvent(offset, suna::EventType::NoteOff, 0.0f, message.getNoteNumber());
+        } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+            wasmDSP_.queueEvent(offset, suna::EventType::AllNotesOff, 0.0f);
+        }
     }
-    
-    if (++paramLogCounter % 500 == 0) {
-        juce::Logger::writeToLog("PARAMS: density=" + juce::String(grainDensityParam_->load(), 4) +
-            " speed=" + juce::String(playbackSpeedParam_->load(), 4) +
-            " grainLen=" + juce::String(grainLengthParam_->load(), 1) +
-            " freeze=" + juce::String(freezeParam_->load(), 1) +
-            " blendX=" + juce::String(blendXParam_->load(), 4) +
-            " blendY=" + juce::String(blendYParam_->load(), 4));
+}
+
+void SunaAudioProcessor::releaseResources()
+{
+}
+
+void SunaAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // Reports allocations, locks and file I/O on this thread in
+    // SUNA_RT_CHECK builds (offline renders may do all three)
+    suna::RtCheck::Scope rtScope(!isNonRealtime());
+    {
+        suna::RtCheck::Disabler firstCallLog;
+        static bool firstCall = true;
+        if (firstCall) {
+            juce::Logger::writeToLog("SunaAudioProcessor::processBlock - First call with " + 
+                juce::String(buffer.getNumSamples()) + " samples");
+            firstCall = false;
+        }
     }
     
     juce::ScopedNoDenormals noDenormals;
@@ -79,21 +142,47 @@ void SunaAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
         return;
     }
 
-    // Clear buffer since we have no input bus
-    buffer.clear();
+    int numSamples = buffer.getNumSamples();
+
+    // The input feeds the live input slot; channels without one hold garbage
+    const int numInputs = getTotalNumInputChannels();
+    for (int ch = numInputs; ch < buffer.getNumChannels(); ++ch) {
+        buffer.clear(ch, 0, numSamples);
+    }
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getNumChannels() > 1 
                          ? buffer.getWritePointer(1) 
                          : leftChannel;
+    // A mono input is heard on both sides of the capture mix
+    const float* rightInput = numInputs > 1 ? rightChannel : leftChannel;
 
-    int numSamples = buffer.getNumSamples();
-
-    wasmDSP_.processBlock(leftChannel, rightChannel, 
+    // Some hosts toggle offline rendering without preparing again
+    if (isNonRealtime() != wasmDSP_.isNonRealtime()) {
+        wasmDSP_.setNonRealtime(isNonRealtime());
+    }
+    {
+        suna::TraceSpan queueSpan("queue_events");
+        queueParameterChanges();
+        queueMidiEvents(midiMessages, numSamples);
+    }
+    wasmDSP_.processBlock(leftChannel, rightInput, 
                          leftChannel, rightChannel, 
                          numSamples);
 }
 
+bool SunaAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo()) {
+        return false;
+    }
+    // The input is optional: without it live input slots record silence
+    const auto input = layouts.getMainInputChannelSet();
+    return input.isDisabled() ||
+           input == juce::AudioChannelSet::mono() ||
+           input == juce::AudioChannelSet::stereo();
+}
+
 juce::AudioProcessorEditor* SunaAudioProcessor::createEditor()
 {
     return new SunaAudioProcessorEditor(*this);
@@ -108,6 +197,7 @@ void SunaAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 
 void SunaAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    suna::TraceSpan restoreSpan("state_restore");
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr && xmlState->hasTagName(parameters_.state.getType())) {
         parameters_.replaceState(juce::ValueTree::fromXml(*xmlState));
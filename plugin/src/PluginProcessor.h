@@ -12,6 +12,7 @@ public:
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     using juce::AudioProcessor::processBlock;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -46,6 +47,11 @@ private:
     std::atomic<float>* grainLengthParam_ = nullptr;
     std::atomic<float>* grainDensityParam_ = nullptr;
     std::atomic<float>* freezeParam_ = nullptr;
+
+    // Parameter values last sent to the DSP (changes become block events)
+    std::array<float, 6> sentParamValues_{};
+    void queueParameterChanges();
+    void queueMidiEvents(const juce::MidiBuffer& midi, int numSamples);
     
     suna::WasmDSP wasmDSP_;
     bool dspInitialized_ = false;
@@ -0,0 +1,184 @@
+#include "suna/RtCheck.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if __has_include(<execinfo.h>) && __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define SUNA_RT_CHECK_BACKTRACE 1
+#else
+#define SUNA_RT_CHECK_BACKTRACE 0
+#endif
+
+namespace suna {
+
+namespace {
+
+constexpr int MAX_FRAMES = 32;
+constexpr size_t MAX_REPORTS = 256;
+
+thread_local int realtimeDepth = 0;
+thread_local int disabledDepth = 0;
+thread_local bool inReport = false;
+
+std::atomic<uint64_t> violationCounts[static_cast<size_t>(RtViolation::Count)];
+std::atomic<bool> abortOnViolation{false};
+
+struct CallSite {
+    uint64_t key;
+    RtCheck::Report report;
+};
+
+std::mutex& reportsMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<CallSite>& callSites() {
+    static std::vector<CallSite> sites;
+    return sites;
+}
+
+#if SUNA_RT_CHECK_BACKTRACE
+// "binary(_ZN4suna7WasmDSP12processBlockE...+0x1c) [0x...]" with the
+// symbol demangled
+std::string describeFrame(const char* frame) {
+    const char* open = std::strchr(frame, '(');
+    const char* plus = open ? std::strchr(open, '+') : nullptr;
+    if (!open || !plus || plus == open + 1) return frame;
+    const std::string mangled(open + 1, plus);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || !demangled) return frame;
+    std::string described = std::string(frame, open + 1) + demangled + plus;
+    std::free(demangled);
+    return described;
+}
+#endif
+
+} // namespace
+
+const char* getRtViolationName(RtViolation kind) {
+    switch (kind) {
+    case RtViolation::Allocation: return "allocation";
+    case RtViolation::Deallocation: return "deallocation";
+    case RtViolation::Lock: return "lock";
+    case RtViolation::FileIo: return "file_io";
+    case RtViolation::Count: break;
+    }
+    return "unknown";
+}
+
+RtCheck::Scope::Scope(bool realtime) : realtime_(realtime) {
+    if (realtime_) ++realtimeDepth;
+}
+
+RtCheck::Scope::~Scope() {
+    if (realtime_) --realtimeDepth;
+}
+
+RtCheck::Disabler::Disabler() {
+    ++disabledDepth;
+}
+
+RtCheck::Disabler::~Disabler() {
+    --disabledDepth;
+}
+
+bool RtCheck::isChecking() {
+    return realtimeDepth > 0 && disabledDepth == 0 && !inReport;
+}
+
+namespace {
+
+// Everything it allocates is freed before it returns, while still unchecked
+void recordViolation(RtViolation kind, const char* call) {
+    violationCounts[static_cast<size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t key = static_cast<uint64_t>(kind) * 1099511628211ull;
+    std::string stack;
+#if SUNA_RT_CHECK_BACKTRACE
+    void* frames[MAX_FRAMES];
+    const int frameCount = backtrace(frames, MAX_FRAMES);
+    for (int i = 0; i < frameCount; ++i) {
+        key = (key ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+    // Frame 0 is the checker itself
+    if (char** symbols = backtrace_symbols(frames, frameCount)) {
+        for (int i = 1; i < frameCount; ++i) {
+            stack += "  #" + std::to_string(i - 1) + " " + describeFrame(symbols[i]) + "\n";
+        }
+        std::free(symbols);
+    }
+#endif
+
+    bool firstAtSite = false;
+    {
+        std::lock_guard<std::mutex> lock(reportsMutex());
+        auto& sites = callSites();
+        CallSite* site = nullptr;
+        for (auto& existing : sites) {
+            if (existing.key == key) {
+                site = &existing;
+                break;
+            }
+        }
+        if (!site && sites.size() < MAX_REPORTS) {
+            sites.push_back({ key, { kind, call, stack, 0 } });
+            site = &sites.back();
+            firstAtSite = true;
+        }
+        if (site) ++site->report.count;
+    }
+
+    if (firstAtSite) {
+        std::fprintf(stderr, "RT-safety violation: %s (%s) on a realtime thread\n%s",
+                     call, getRtViolationName(kind), stack.c_str());
+    }
+    if (abortOnViolation.load(std::memory_order_relaxed)) {
+        std::abort();
+    }
+}
+
+} // namespace
+
+void RtCheck::report(RtViolation kind, const char* call) {
+    if (!isChecking()) return;
+    // Reporting allocates, locks and writes; none of that is checked
+    inReport = true;
+    recordViolation(kind, call);
+    inReport = false;
+}
+
+uint64_t RtCheck::getViolationCount() {
+    uint64_t total = 0;
+    for (const auto& count : violationCounts) total += count.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t RtCheck::getViolationCount(RtViolation kind) {
+    if (kind == RtViolation::Count) return 0;
+    return violationCounts[static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+}
+
+std::vector<RtCheck::Report> RtCheck::getReports() {
+    std::lock_guard<std::mutex> lock(reportsMutex());
+    std::vector<Report> reports;
+    for (const auto& site : callSites()) reports.push_back(site.report);
+    return reports;
+}
+
+void RtCheck::reset() {
+    std::lock_guard<std::mutex> lock(reportsMutex());
+    callSites().clear();
+    for (auto& count : violationCounts) count.store(0, std::memory_order_relaxed);
+}
+
+void RtCheck::setAbortOnViolation(bool abort) {
+    abortOnViolation.store(abort, std::memory_order_relaxed);
+}
+
+} // namespace suna
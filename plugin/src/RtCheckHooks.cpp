@@ -0,0 +1,243 @@
+// RtCheck interceptors: link this file into an executable (rt_check_test,
+// or Suna_Standalone with -DSUNA_RT_CHECK=ON) to have RtCheck see its
+// allocations, locks and file I/O. operator new/delete are replaceable
+// everywhere; the C library functions are interposed on glibc only, where
+// the real ones stay reachable.
+
+// open/fopen are defined below, so the headers must not redirect them (to
+// open64, or to fortified inline versions)
+#undef _FILE_OFFSET_BITS
+#undef _FORTIFY_SOURCE
+
+#include "suna/RtCheck.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+static void* rawMalloc(size_t size) { return __libc_malloc(size); }
+static void* rawAlignedMalloc(size_t alignment, size_t size) { return __libc_memalign(alignment, size); }
+static void rawFree(void* pointer) { __libc_free(pointer); }
+#else
+static void* rawMalloc(size_t size) { return std::malloc(size); }
+static void* rawAlignedMalloc(size_t alignment, size_t size) {
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+static void rawFree(void* pointer) { std::free(pointer); }
+#endif
+
+static void checkCall(suna::RtViolation kind, const char* call) {
+    if (suna::RtCheck::isChecking()) suna::RtCheck::report(kind, call);
+}
+
+void* operator new(std::size_t size) {
+    checkCall(suna::RtViolation::Allocation, "operator new");
+    if (void* pointer = rawMalloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    checkCall(suna::RtViolation::Deallocation, "operator delete");
+    rawFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+}
+
+// Over-aligned types (alignas above the default new alignment)
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    checkCall(suna::RtViolation::Allocation, "operator new");
+    if (void* pointer = rawAlignedMalloc(static_cast<std::size_t>(alignment), size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    ::operator delete(pointer);
+}
+
+#if defined(__GLIBC__)
+namespace {
+
+template <typename Function>
+Function realFunction(std::atomic<void*>& cache, const char* name) {
+    void* function = cache.load(std::memory_order_acquire);
+    if (!function) {
+        function = dlsym(RTLD_NEXT, name);
+        cache.store(function, std::memory_order_release);
+    }
+    return reinterpret_cast<Function>(function);
+}
+
+std::atomic<void*> realMutexLock{nullptr};
+std::atomic<void*> realOpen{nullptr};
+std::atomic<void*> realOpen64{nullptr};
+std::atomic<void*> realOpenat{nullptr};
+std::atomic<void*> realFopen{nullptr};
+std::atomic<void*> realFopen64{nullptr};
+std::atomic<void*> realRead{nullptr};
+std::atomic<void*> realWrite{nullptr};
+
+// Resolved before main, so the first intercepted call does not run dlsym
+struct ResolveRealFunctions {
+    ResolveRealFunctions() {
+        realFunction<void*>(realMutexLock, "pthread_mutex_lock");
+        realFunction<void*>(realOpen, "open");
+        realFunction<void*>(realOpen64, "open64");
+        realFunction<void*>(realOpenat, "openat");
+        realFunction<void*>(realFopen, "fopen");
+        realFunction<void*>(realFopen64, "fopen64");
+        realFunction<void*>(realRead, "read");
+        realFunction<void*>(realWrite, "write");
+    }
+} resolveRealFunctions;
+
+// open's mode argument is only passed when a file may be created
+mode_t openMode(int flags, va_list args) {
+    return (flags & (O_CREAT | O_TMPFILE)) ? static_cast<mode_t>(va_arg(args, int)) : 0;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+    checkCall(suna::RtViolation::Allocation, "malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    checkCall(suna::RtViolation::Allocation, "calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+    checkCall(suna::RtViolation::Allocation, "realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    checkCall(suna::RtViolation::Allocation, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept {
+    checkCall(suna::RtViolation::Allocation, "posix_memalign");
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* memory = __libc_memalign(alignment, size);
+    if (!memory) return ENOMEM;
+    *pointer = memory;
+    return 0;
+}
+
+void free(void* pointer) noexcept {
+    if (!pointer) return;
+    checkCall(suna::RtViolation::Deallocation, "free");
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+    checkCall(suna::RtViolation::Lock, "pthread_mutex_lock");
+    return realFunction<int (*)(pthread_mutex_t*)>(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int open(const char* path, int flags, ...) {
+    checkCall(suna::RtViolation::FileIo, "open");
+    va_list args;
+    va_start(args, flags);
+    const mode_t mode = openMode(flags, args);
+    va_end(args);
+    return realFunction<int (*)(const char*, int, ...)>(realOpen, "open")(path, flags, mode);
+}
+
+int open64(const char* path, int flags, ...) {
+    checkCall(suna::RtViolation::FileIo, "open64");
+    va_list args;
+    va_start(args, flags);
+    const mode_t mode = openMode(flags, args);
+    va_end(args);
+    return realFunction<int (*)(const char*, int, ...)>(realOpen64, "open64")(path, flags, mode);
+}
+
+int openat(int directory, const char* path, int flags, ...) {
+    checkCall(suna::RtViolation::FileIo, "openat");
+    va_list args;
+    va_start(args, flags);
+    const mode_t mode = openMode(flags, args);
+    va_end(args);
+    return realFunction<int (*)(int, const char*, int, ...)>(realOpenat, "openat")(
+        directory, path, flags, mode);
+}
+
+FILE* fopen(const char* path, const char* mode) {
+    checkCall(suna::RtViolation::FileIo, "fopen");
+    return realFunction<FILE* (*)(const char*, const char*)>(realFopen, "fopen")(path, mode);
+}
+
+FILE* fopen64(const char* path, const char* mode) {
+    checkCall(suna::RtViolation::FileIo, "fopen64");
+    return realFunction<FILE* (*)(const char*, const char*)>(realFopen64, "fopen64")(path, mode);
+}
+
+ssize_t read(int fd, void* buffer, size_t size) {
+    checkCall(suna::RtViolation::FileIo, "read");
+    return realFunction<ssize_t (*)(int, void*, size_t)>(realRead, "read")(fd, buffer, size);
+}
+
+ssize_t write(int fd, const void* buffer, size_t size) {
+    checkCall(suna::RtViolation::FileIo, "write");
+    return realFunction<ssize_t (*)(int, const void*, size_t)>(realWrite, "write")(fd, buffer, size);
+}
+
+} // extern "C"
+#endif // __GLIBC__
@@ -0,0 +1,147 @@
+#include "suna/SampleStore.h"
+#include <algorithm>
+#include <cstring>
+
+namespace suna {
+
+SampleStore& SampleStore::instance() {
+    static SampleStore store;
+    return store;
+}
+
+void SampleStore::setHeap(std::shared_ptr<SampleHeap> heap) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    heap_ = std::move(heap);
+    // Entries of the old heap are at addresses the new one does not map
+    samples_.clear();
+}
+
+std::shared_ptr<const SharedSample> SampleStore::acquire(const float* data, int length) {
+    if (!data || length <= 0) return nullptr;
+
+    const uint64_t hash = hashSamples(data, length);
+    const size_t bytes = static_cast<size_t>(length) * sizeof(float);
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!heap_) return nullptr;
+
+    auto it = samples_.find(hash);
+    if (it != samples_.end()) {
+        if (auto existing = it->second.lock()) {
+            if (existing->length == length && std::memcmp(existing->data, data, bytes) == 0) {
+                return existing;
+            }
+            // Hash collision: keep this one unshared (not in the map)
+            return allocate(hash, data, length);
+        }
+    }
+
+    auto shared = allocate(hash, data, length);
+    if (shared) {
+        samples_[hash] = shared;
+    }
+    return shared;
+}
+
+std::shared_ptr<const SharedSample> SampleStore::allocate(uint64_t hash, const float* data, int length) {
+    const size_t bytes = static_cast<size_t>(length) * sizeof(float);
+    void* native = nullptr;
+    const uint64_t offset = heap_->allocate(bytes, native);
+    if (!offset || !native) return nullptr;
+    std::memcpy(native, data, bytes);
+    bytesInUse_ += bytes;
+
+    auto* sample = new SharedSample{ hash, offset, static_cast<const float*>(native), length };
+    // The entry holds its heap until it is freed
+    return std::shared_ptr<const SharedSample>(
+        sample, [this, heap = heap_](const SharedSample* s) {
+            release(const_cast<SharedSample*>(s), *heap);
+        });
+}
+
+void SampleStore::release(SharedSample* sample, SampleHeap& heap) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+    auto it = samples_.find(sample->hash);
+    if (it != samples_.end() && it->second.expired()) {
+        samples_.erase(it);
+    }
+    heap.free(sample->appOffset);
+    bytesInUse_ -= static_cast<size_t>(sample->length) * sizeof(float);
+    delete sample;
+}
+
+size_t SampleStore::getSampleCount() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return samples_.size();
+}
+
+size_t SampleStore::getBytesInUse() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return bytesInUse_;
+}
+
+uint64_t SampleStore::hashSamples(const float* data, int length) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    const size_t size = static_cast<size_t>(length) * sizeof(float);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#if SUNA_SHARED_SAMPLES
+std::shared_ptr<WamrSampleHeap> WamrSampleHeap::create() {
+    SharedHeapInitArgs args;
+    std::memset(&args, 0, sizeof(SharedHeapInitArgs));
+    args.size = HEAP_SIZE;
+    wasm_shared_heap_t heap = wasm_runtime_create_shared_heap(&args);
+    if (!heap) return nullptr;
+    return std::shared_ptr<WamrSampleHeap>(new WamrSampleHeap(heap));
+}
+
+bool WamrSampleHeap::attach(wasm_module_inst_t moduleInst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!wasm_runtime_attach_shared_heap(moduleInst, heap_)) {
+        return false;
+    }
+    attached_.push_back(moduleInst);
+    for (const uint64_t offset : pendingFrees_) {
+        wasm_runtime_shared_heap_free(moduleInst, offset);
+    }
+    pendingFrees_.clear();
+    return true;
+}
+
+void WamrSampleHeap::detach(wasm_module_inst_t moduleInst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = std::find(attached_.begin(), attached_.end(), moduleInst);
+    if (it == attached_.end()) return;
+    wasm_runtime_detach_shared_heap(moduleInst);
+    attached_.erase(it);
+}
+
+uint64_t WamrSampleHeap::allocate(size_t bytes, void*& native) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (attached_.empty()) return 0;
+    return wasm_runtime_shared_heap_malloc(attached_.front(), bytes, &native);
+}
+
+void WamrSampleHeap::free(uint64_t appOffset) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Any attached instance can free
+    if (attached_.empty()) {
+        pendingFrees_.push_back(appOffset);
+        return;
+    }
+    wasm_runtime_shared_heap_free(attached_.front(), appOffset);
+}
+#endif
+
+} // namespace suna
@@ -0,0 +1,267 @@
+#include "suna/Trace.h"
+#include "suna/RtCheck.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace suna {
+
+namespace {
+
+constexpr uint64_t INSTANT_DURATION = std::numeric_limits<uint64_t>::max();
+
+struct TraceEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;   // INSTANT_DURATION for instant events
+};
+
+/** Events of one thread; that thread is the only writer */
+struct ThreadRing {
+    // Set around every append, so a dump can wait for writes in flight
+    std::atomic<bool> busy{false};
+    // Held by a live thread; an exited thread's events stay until the ring
+    // is claimed again
+    std::atomic<bool> owned{false};
+    std::atomic<int> tid{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<const char*> name{nullptr};
+    TraceEvent events[Trace::EVENTS_PER_THREAD];
+};
+
+// Allocated by the first start() and never freed, so a ring outlives any
+// thread still holding it at exit
+std::atomic<ThreadRing*> rings{nullptr};
+std::atomic<int> nextTid{1};
+
+// Rings given back by exited threads, so threads without one try again
+std::atomic<uint32_t> releasedRings{0};
+// Threads that found every ring held (reported in the trace)
+std::atomic<int> untracedThreads{0};
+
+// Serializes start(), stop() and dumps (never taken while recording)
+std::mutex controlMutex;
+
+/** Gives the calling thread's ring back when the thread exits */
+struct RingOwner {
+    ThreadRing* ring = nullptr;
+    bool missed = false;            // counted in untracedThreads
+    uint32_t missedAtRelease = 0;   // releasedRings when no ring was free
+
+    ~RingOwner() {
+        if (!ring) return;
+        ring->owned.store(false, std::memory_order_release);
+        releasedRings.fetch_add(1, std::memory_order_release);
+    }
+};
+
+thread_local RingOwner threadRing;
+
+// Claims a free ring and clears it for this thread. Like append(), it
+// runs inside the ring's busy window, so a dump never sees it half done.
+ThreadRing* claimRing(ThreadRing* all) {
+    for (int i = 0; i < Trace::MAX_THREADS; ++i) {
+        ThreadRing& ring = all[i];
+        bool expected = false;
+        if (!ring.owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            continue;
+        }
+        ring.busy.store(true);
+        if (!Trace::isEnabled()) {
+            ring.busy.store(false, std::memory_order_release);
+            ring.owned.store(false, std::memory_order_release);
+            return nullptr;
+        }
+        ring.tid.store(nextTid.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        ring.written.store(0, std::memory_order_relaxed);
+        ring.name.store(nullptr, std::memory_order_relaxed);
+        ring.busy.store(false, std::memory_order_release);
+        return &ring;
+    }
+    return nullptr;
+}
+
+ThreadRing* ringForThisThread() {
+    RingOwner& owner = threadRing;
+    if (owner.ring) return owner.ring;
+    if (owner.missed &&
+        owner.missedAtRelease == releasedRings.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    ThreadRing* all = rings.load(std::memory_order_acquire);
+    if (!all) return nullptr;
+
+    // A thread's first use registers RingOwner's exit hook, which may
+    // allocate once
+    RtCheck::Disabler threadSetup;
+    const uint32_t released = releasedRings.load(std::memory_order_acquire);
+    owner.ring = claimRing(all);
+    if (!owner.ring && Trace::isEnabled()) {
+        if (!owner.missed) untracedThreads.fetch_add(1, std::memory_order_relaxed);
+        owner.missed = true;
+        owner.missedAtRelease = released;
+    }
+    return owner.ring;
+}
+
+} // namespace
+
+std::atomic<bool> Trace::enabled_{false};
+
+uint64_t Trace::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Trace::append(const char* name, uint64_t startNs, uint64_t durationNs) {
+    ThreadRing* ring = ringForThisThread();
+    if (!ring) return;
+    // busy and enabled_ are both seq_cst: either pauseRecording() sees this
+    // write in flight, or this write sees recording paused
+    ring->busy.store(true);
+    if (enabled_.load()) {
+        const uint64_t index = ring->written.load(std::memory_order_relaxed);
+        ring->events[index % EVENTS_PER_THREAD] = { name, startNs, durationNs };
+        ring->written.store(index + 1, std::memory_order_release);
+    }
+    ring->busy.store(false, std::memory_order_release);
+}
+
+void Trace::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    if (!isEnabled()) return;
+    append(name, startNs, endNs > startNs ? endNs - startNs : 0);
+}
+
+void Trace::instant(const char* name) {
+    if (!isEnabled()) return;
+    append(name, nowNs(), INSTANT_DURATION);
+}
+
+void Trace::setThreadName(const char* name) {
+    ThreadRing* ring = ringForThisThread();
+    if (!ring) return;
+    const char* expected = nullptr;
+    ring->name.compare_exchange_strong(expected, name, std::memory_order_relaxed);
+}
+
+void Trace::pauseRecording() {
+    enabled_.store(false);
+    ThreadRing* all = rings.load(std::memory_order_acquire);
+    if (!all) return;
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        while (all[i].busy.load()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void Trace::start() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    ThreadRing* all = rings.load(std::memory_order_acquire);
+    if (!all) {
+        all = new ThreadRing[MAX_THREADS];
+        rings.store(all, std::memory_order_release);
+    }
+    pauseRecording();
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        all[i].written.store(0, std::memory_order_relaxed);
+    }
+    untracedThreads.store(0, std::memory_order_relaxed);
+    enabled_.store(true);
+}
+
+void Trace::stop() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    enabled_.store(false);
+}
+
+bool Trace::writeChromeTrace(const std::string& path, std::string& error) {
+    struct ThreadEvents {
+        int tid;
+        const char* name;
+        std::vector<TraceEvent> events;
+    };
+    std::vector<ThreadEvents> threads;
+    int untraced = 0;
+    {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        ThreadRing* all = rings.load(std::memory_order_acquire);
+        if (!all) {
+            error = "tracing was never started";
+            return false;
+        }
+        const bool wasEnabled = enabled_.load();
+        pauseRecording();
+        for (int i = 0; i < MAX_THREADS; ++i) {
+            const uint64_t written = all[i].written.load(std::memory_order_acquire);
+            if (written == 0 && !all[i].owned.load(std::memory_order_acquire)) continue;
+            const uint64_t count = std::min<uint64_t>(written, EVENTS_PER_THREAD);
+            ThreadEvents thread{ all[i].tid.load(std::memory_order_relaxed),
+                                 all[i].name.load(std::memory_order_relaxed), {} };
+            thread.events.reserve(static_cast<size_t>(count));
+            for (uint64_t n = written - count; n < written; ++n) {
+                thread.events.push_back(all[i].events[n % EVENTS_PER_THREAD]);
+            }
+            threads.push_back(std::move(thread));
+        }
+        untraced = untracedThreads.load(std::memory_order_relaxed);
+        enabled_.store(wasEnabled);
+    }
+
+    // Timestamps start at the earliest recorded event
+    uint64_t originNs = std::numeric_limits<uint64_t>::max();
+    for (const auto& thread : threads) {
+        for (const auto& event : thread.events) originNs = std::min(originNs, event.startNs);
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    char line[256];
+    bool first = true;
+    for (const auto& thread : threads) {
+        std::snprintf(line, sizeof(line),
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", thread.tid,
+            thread.name ? thread.name : ("thread " + std::to_string(thread.tid)).c_str());
+        file << line;
+        first = false;
+        for (const auto& event : thread.events) {
+            const double ts = static_cast<double>(event.startNs - originNs) / 1000.0;
+            if (event.durationNs == INSTANT_DURATION) {
+                std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+                    event.name, thread.tid, ts);
+            } else {
+                std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, thread.tid, ts, static_cast<double>(event.durationNs) / 1000.0);
+            }
+            file << line;
+        }
+    }
+    // Threads that recorded nothing because all rings were held
+    if (untraced > 0) {
+        std::snprintf(line, sizeof(line),
+            "%s{\"name\":\"untraced_threads\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,"
+            "\"ts\":0,\"args\":{\"count\":%d}}",
+            first ? "" : ",\n", untraced);
+        file << line;
+    }
+    file << "\n]}\n";
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace suna
@@ -1,10 +1,20 @@
 #include "suna/WasmDSP.h"
+#include "suna/NativeDSP.h"
+#include "suna/RtCheck.h"
+#include "suna/SampleStore.h"
+#include "suna/Trace.h"
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <chrono>
 #include <thread>
 #include <functional>
 #include <string>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
 // Conditional JUCE support for standalone test builds
 #if __has_include(<juce_core/juce_core.h>)
 #include <juce_core/juce_core.h>
@@ -37,128 +47,243 @@ static NativeSymbol nativeSymbols[] = {
     { "print_char", (void*)spectestPrintChar, "(i)", nullptr }
 };
 
-WasmDSP::WasmDSP() {
-    std::memset(heapBuf_, 0, HEAP_BUF_SIZE);
+static constexpr uint32_t WASM_STACK_SIZE = 16384;
+static constexpr uint32_t WASM_HEAP_SIZE = 64 * 1024 * 1024;
+
+// The WAMR runtime is process-wide (wasm_runtime_full_init only counts
+// repeated calls), so its pool and the shared sample heap belong to no
+// WasmDSP: the first one to initialize creates them and the last one to
+// shut down destroys them
+struct WamrRuntime {
+    std::mutex mutex;
+    int users = 0;
+    std::unique_ptr<char[]> pool;
+#if SUNA_SHARED_SAMPLES
+    std::shared_ptr<WamrSampleHeap> sampleHeap;
+#endif
+};
+
+static WamrRuntime& getWamrRuntime() {
+    static WamrRuntime runtime;
+    return runtime;
+}
+
+// Idle render workers poll this many times (a CPU pause apart) before they
+// sleep until the next chunk is queued
+static constexpr int WORKER_SPIN_LIMIT = 4000;
+
+// The audio thread wakes workers without taking wakeMutex_, so a wake-up
+// can slip in between a worker's last check and its wait; it then sleeps
+// at most this long
+static constexpr auto WORKER_SLEEP_LIMIT = std::chrono::milliseconds(2);
+
+// Fraction of a chunk's duration a queued share waits for its worker
+// before the audio thread renders it itself
+static constexpr double WORKER_CLAIM_DEADLINE = 0.25;
+
+// Trace names of dropped-block instants, indexed by DropReason
+static const char* const DROP_TRACE_NAMES[] = {
+    "drop_thread_env_init", "drop_not_prepared", "drop_lock_contention",
+    "drop_memory_unavailable", "drop_wasm_exception", "drop_worker_exception"
+};
+static_assert(sizeof(DROP_TRACE_NAMES) / sizeof(DROP_TRACE_NAMES[0]) ==
+              static_cast<size_t>(DropReason::Count), "one trace name per DropReason");
+
+/** Spin-wait hint: lets the sibling hyperthread run and saves power */
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/** The WASM lock, traced as lock_wait until it is taken and then as the holder */
+class TracedLock {
+public:
+    TracedLock(std::recursive_mutex& mutex, const char* holder)
+        : lock_(acquire(mutex)), hold_(holder) {}
+
+private:
+    static std::unique_lock<std::recursive_mutex> acquire(std::recursive_mutex& mutex) {
+        TraceSpan wait("lock_wait");
+        return std::unique_lock<std::recursive_mutex>(mutex);
+    }
+
+    std::unique_lock<std::recursive_mutex> lock_;
+    TraceSpan hold_;
+};
+
+const char* getDropReasonName(DropReason reason) {
+    switch (reason) {
+    case DropReason::ThreadEnvInit: return "thread_env_init";
+    case DropReason::NotPrepared: return "not_prepared";
+    case DropReason::LockContention: return "lock_contention";
+    case DropReason::MemoryUnavailable: return "memory_unavailable";
+    case DropReason::WasmException: return "wasm_exception";
+    case DropReason::WorkerException: return "worker_exception";
+    case DropReason::Count: break;
+    }
+    return "unknown";
+}
+
+uint64_t DspStats::getTotalDropped() const {
+    uint64_t total = 0;
+    for (uint64_t count : dropped) total += count;
+    return total;
 }
 
+WasmDSP::WasmDSP() = default;
+
 WasmDSP::~WasmDSP() {
     shutdown();
 }
 
-bool WasmDSP::initialize(const uint8_t* aotData, size_t size) {
-    SUNA_LOG("WasmDSP::initialize() - Loading AOT module...");
+bool WasmDSP::initialize(const uint8_t* aotData, size_t size, int renderThreads,
+                         DspBackendType backend) {
+    SUNA_LOG("WasmDSP::initialize() - Loading " + std::string(getBackendName(backend)) + " DSP...");
     if (initialized_) {
         shutdown();
     }
 
-    aotDataCopy_ = static_cast<uint8_t*>(std::malloc(size));
-    if (!aotDataCopy_) {
-        SUNA_LOG("WasmDSP::initialize() - Failed: malloc failed");
+    renderThreads = std::clamp(renderThreads, 1, MAX_RENDER_THREADS);
+    backendType_ = backend;
+    // The native engine needs neither the runtime nor the AOT module
+    if (backend == DspBackendType::WamrAot && !initializeRuntime(aotData, size)) {
         return false;
     }
-    std::memcpy(aotDataCopy_, aotData, size);
-    aotDataSize_ = size;
-
-    RuntimeInitArgs initArgs;
-    std::memset(&initArgs, 0, sizeof(RuntimeInitArgs));
-    initArgs.mem_alloc_type = Alloc_With_Pool;
-    initArgs.mem_alloc_option.pool.heap_buf = heapBuf_;
-    initArgs.mem_alloc_option.pool.heap_size = HEAP_BUF_SIZE;
 
-    if (!wasm_runtime_full_init(&initArgs)) {
-        SUNA_LOG("WasmDSP::initialize() - Failed: wasm_runtime_full_init failed");
-        std::free(aotDataCopy_);
-        aotDataCopy_ = nullptr;
+    std::string error;
+    backend_ = createBackend(error);
+    if (!backend_) {
+        SUNA_LOG("WasmDSP::initialize() - Failed: " + error);
+        shutdown();
         return false;
     }
 
-    if (!wasm_runtime_register_natives("spectest", nativeSymbols,
-                                        sizeof(nativeSymbols) / sizeof(NativeSymbol))) {
-        SUNA_LOG("WasmDSP::initialize() - Failed: wasm_runtime_register_natives failed");
-        wasm_runtime_destroy();
-        std::free(aotDataCopy_);
-        aotDataCopy_ = nullptr;
-        return false;
+#if SUNA_SHARED_SAMPLES
+    // Workers attach too; until then a store address reads nothing
+    sharedSamples_ = sampleHeap_ && sampleHeap_->attach(backend_->getModuleInstance());
+    if (backendType_ == DspBackendType::WamrAot && !sharedSamples_) {
+        SUNA_LOG("WasmDSP::initialize() - Shared sample heap unavailable, samples are copied");
     }
+#endif
 
-    char errorBuf[128];
-    module_ = wasm_runtime_load(aotDataCopy_, static_cast<uint32_t>(aotDataSize_),
-                                 errorBuf, sizeof(errorBuf));
-    if (!module_) {
-        SUNA_LOG(std::string("WasmDSP::initialize() - Failed: wasm_runtime_load failed - ") + errorBuf);
-        wasm_runtime_destroy();
-        std::free(aotDataCopy_);
-        aotDataCopy_ = nullptr;
-        return false;
+    if (renderThreads > 1 && !startWorkers(renderThreads - 1)) {
+        SUNA_LOG("WasmDSP::initialize() - Render workers unavailable, using one thread");
+        stopWorkers();
     }
+    setRenderPartition(*backend_, 0, getRenderThreadCount());
 
-    constexpr uint32_t stackSize = 16384;
-    constexpr uint32_t heapSize = 64 * 1024 * 1024;
-    moduleInst_ = wasm_runtime_instantiate(module_, stackSize, heapSize,
-                                            errorBuf, sizeof(errorBuf));
-    if (!moduleInst_) {
-        SUNA_LOG(std::string("WasmDSP::initialize() - Failed: wasm_runtime_instantiate failed - ") + errorBuf);
-        wasm_runtime_unload(module_);
-        module_ = nullptr;
-        wasm_runtime_destroy();
-        std::free(aotDataCopy_);
-        aotDataCopy_ = nullptr;
-        return false;
+    initialized_ = true;
+    SUNA_LOG("WasmDSP::initialize() - Success");
+    return true;
+}
+
+bool WasmDSP::acquireRuntime() {
+    WamrRuntime& runtime = getWamrRuntime();
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    if (runtime.users == 0) {
+        size_t poolSize = WAMR_POOL_SIZE;
+#if SUNA_SHARED_SAMPLES
+        // The shared sample heap is allocated from this pool
+        poolSize += WamrSampleHeap::HEAP_SIZE;
+#endif
+        // Not zeroed: WAMR clears what it hands out, and the OS commits the
+        // pages of a large allocation only as they are used
+        runtime.pool.reset(new (std::nothrow) char[poolSize]);
+        if (!runtime.pool) {
+            SUNA_LOG("WasmDSP::initialize() - Failed: WAMR pool allocation failed");
+            return false;
+        }
+
+        RuntimeInitArgs initArgs;
+        std::memset(&initArgs, 0, sizeof(RuntimeInitArgs));
+        initArgs.mem_alloc_type = Alloc_With_Pool;
+        initArgs.mem_alloc_option.pool.heap_buf = runtime.pool.get();
+        initArgs.mem_alloc_option.pool.heap_size = static_cast<uint32_t>(poolSize);
+        if (!wasm_runtime_full_init(&initArgs)) {
+            SUNA_LOG("WasmDSP::initialize() - Failed: wasm_runtime_full_init failed");
+            runtime.pool.reset();
+            return false;
+        }
+        if (!wasm_runtime_register_natives("spectest", nativeSymbols,
+                                            sizeof(nativeSymbols) / sizeof(NativeSymbol))) {
+            SUNA_LOG("WasmDSP::initialize() - Failed: wasm_runtime_register_natives failed");
+            wasm_runtime_destroy();
+            runtime.pool.reset();
+            return false;
+        }
+#if SUNA_SHARED_SAMPLES
+        runtime.sampleHeap = WamrSampleHeap::create();
+        SampleStore::instance().setHeap(runtime.sampleHeap);
+#endif
     }
+    ++runtime.users;
+#if SUNA_SHARED_SAMPLES
+    sampleHeap_ = runtime.sampleHeap;
+#endif
+    runtimeInitialized_ = true;
+    return true;
+}
 
-    execEnv_ = wasm_runtime_create_exec_env(moduleInst_, stackSize);
-    if (!execEnv_) {
-        SUNA_LOG("WasmDSP::initialize() - Failed: wasm_runtime_create_exec_env failed");
-        wasm_runtime_deinstantiate(moduleInst_);
-        moduleInst_ = nullptr;
-        wasm_runtime_unload(module_);
-        module_ = nullptr;
-        wasm_runtime_destroy();
-        std::free(aotDataCopy_);
-        aotDataCopy_ = nullptr;
+void WasmDSP::releaseRuntime() {
+    if (!runtimeInitialized_) return;
+    runtimeInitialized_ = false;
+#if SUNA_SHARED_SAMPLES
+    sampleHeap_.reset();
+#endif
+
+    WamrRuntime& runtime = getWamrRuntime();
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    if (--runtime.users > 0) return;
+#if SUNA_SHARED_SAMPLES
+    // Every slot holding a stored sample has been cleared by now
+    SampleStore::instance().setHeap(nullptr);
+    runtime.sampleHeap.reset();
+#endif
+    wasm_runtime_destroy();
+    runtime.pool.reset();
+}
+
+bool WasmDSP::initializeRuntime(const uint8_t* aotData, size_t size) {
+    if (!acquireRuntime()) {
         return false;
     }
 
-    if (!lookupFunctions()) {
-        SUNA_LOG("WasmDSP::initialize() - Failed: lookupFunctions failed");
+    aotDataCopy_ = static_cast<uint8_t*>(std::malloc(size));
+    if (!aotDataCopy_) {
+        SUNA_LOG("WasmDSP::initialize() - Failed: malloc failed");
         shutdown();
         return false;
     }
+    std::memcpy(aotDataCopy_, aotData, size);
+    aotDataSize_ = size;
 
-    initialized_ = true;
-    SUNA_LOG("WasmDSP::initialize() - Success");
+    char errorBuf[128];
+    module_ = wasm_runtime_load(aotDataCopy_, static_cast<uint32_t>(aotDataSize_),
+                                 errorBuf, sizeof(errorBuf));
+    if (!module_) {
+        SUNA_LOG(std::string("WasmDSP::initialize() - Failed: wasm_runtime_load failed - ") + errorBuf);
+        shutdown();
+        return false;
+    }
     return true;
 }
 
-bool WasmDSP::lookupFunctions() {
-    initSamplerFunc_ = wasm_runtime_lookup_function(moduleInst_, "init_sampler");
-    loadSampleFunc_ = wasm_runtime_lookup_function(moduleInst_, "load_sample");
-    clearSlotFunc_ = wasm_runtime_lookup_function(moduleInst_, "clear_slot");
-    playAllFunc_ = wasm_runtime_lookup_function(moduleInst_, "play_all");
-    stopAllFunc_ = wasm_runtime_lookup_function(moduleInst_, "stop_all");
-    getSlotLengthFunc_ = wasm_runtime_lookup_function(moduleInst_, "get_slot_length");
-    processBlockFunc_ = wasm_runtime_lookup_function(moduleInst_, "process_block");
-    setBlendXFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_blend_x");
-    setBlendYFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_blend_y");
-    setPlaybackSpeedFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_playback_speed");
-    setGrainLengthFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_grain_length");
-    setGrainDensityFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_grain_density");
-    setFreezeFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_freeze");
-    setSpeedTargetFunc_ = wasm_runtime_lookup_function(moduleInst_, "set_speed_target");
-
-    return initSamplerFunc_ && loadSampleFunc_ && clearSlotFunc_ &&
-           playAllFunc_ && stopAllFunc_ && getSlotLengthFunc_ && processBlockFunc_ &&
-           setBlendXFunc_ && setBlendYFunc_ && setPlaybackSpeedFunc_ &&
-           setGrainLengthFunc_ && setGrainDensityFunc_ && setFreezeFunc_ && setSpeedTargetFunc_;
+std::unique_ptr<DspBackend> WasmDSP::createBackend(std::string& error) {
+    if (backendType_ == DspBackendType::Native) {
+        return NativeBackend::create(error);
+    }
+    return WamrBackend::create(module_, WASM_STACK_SIZE, WASM_HEAP_SIZE, error);
 }
 
 bool WasmDSP::refreshMemoryBase() {
-    if (!moduleInst_) {
+    if (!backend_) {
         return false;
     }
 
-    uint8_t* memBase = static_cast<uint8_t*>(
-        wasm_runtime_addr_app_to_native(moduleInst_, 0));
+    uint8_t* memBase = backend_->getMemoryBase();
     if (!memBase) {
         SUNA_LOG("WasmDSP::refreshMemoryBase() - Failed: memBase is null");
         return false;
@@ -183,10 +308,17 @@ bool WasmDSP::refreshMemoryBase() {
 }
 
 bool WasmDSP::allocateBuffers(int maxBlockSize) {
+    static_assert(BUFFER_START + 4 * MAX_IO_BLOCK_SIZE * sizeof(float) <= SAMPLE_DATA_START,
+                  "I/O buffers overlap the sample slots");
+    // The four I/O buffers must end below slot 0's data
+    if (maxBlockSize > MAX_IO_BLOCK_SIZE) {
+        SUNA_LOG("WasmDSP: block size " + std::to_string(maxBlockSize) +
+                 " clamped to " + std::to_string(MAX_IO_BLOCK_SIZE));
+        maxBlockSize = MAX_IO_BLOCK_SIZE;
+    }
     uint32_t bufferBytes = static_cast<uint32_t>(maxBlockSize) * sizeof(float);
 
-    uint8_t* memBase = static_cast<uint8_t*>(
-        wasm_runtime_addr_app_to_native(moduleInst_, 0));
+    uint8_t* memBase = backend_->getMemoryBase();
     if (!memBase) {
         SUNA_LOG("WasmDSP::allocateBuffers() - Failed: memBase is null");
         return false;
@@ -211,6 +343,17 @@ bool WasmDSP::allocateBuffers(int maxBlockSize) {
      * │   - Right Input (maxBlockSize * sizeof(float))                  │
      * │   - Left Output (maxBlockSize * sizeof(float))                  │
      * │   - Right Output(maxBlockSize * sizeof(float))                  │
+     * │ 1000000 (SAMPLE_DATA_START):     Sample Slots                   │
+     * │   - 8 slots * MAX_SAMPLES_PER_SLOT floats                       │
+     * │ 48000000:                        Freeze Loop Cache (MoonBit)    │
+     * │   - 1440000 floats, written and read by the DSP only            │
+     * │ 54000000 (CONTROL_REGION_START): Control Header (state_ptr)     │
+     * │   - i32 lane flags, i32 lane capacity, i32 event count,         │
+     * │     i32 lane read offset (chunk start within the host block)    │
+     * │   - Modulation lanes (3 * maxBlockSize * sizeof(float))         │
+     * │   - Event list (MAX_BLOCK_EVENTS * sizeof(DspEvent))            │
+     * │ 56000000 (CAPTURE_RING_START):   Live Input Capture Ring        │
+     * │   - 2 * CAPTURE_RING_SAMPLES floats, written and read by the DSP│
      * └─────────────────────────────────────────────────────────────────┘
      * 
      * BUFFER_START = 900000 is chosen to:
@@ -221,19 +364,22 @@ bool WasmDSP::allocateBuffers(int maxBlockSize) {
      * WARNING: Do not change this value without updating MoonBit code.
      * The MoonBit DSP expects audio buffers at this exact offset.
      */
-    constexpr uint32_t BUFFER_START = 900000;
 
     // Validate WASM memory is large enough for our buffer layout
-    uint32_t requiredSize = BUFFER_START + (4 * bufferBytes);
-    wasm_memory_inst_t memoryInst = wasm_runtime_get_default_memory(moduleInst_);
-    if (memoryInst) {
-        uint64_t pageCount = wasm_memory_get_cur_page_count(memoryInst);
-        uint64_t bytesPerPage = wasm_memory_get_bytes_per_page(memoryInst);
-        uint64_t actualSize = pageCount * bytesPerPage;
-        if (actualSize < requiredSize) {
-            SUNA_LOG("WasmDSP: WASM memory too small: " + std::to_string(actualSize) + " bytes < required " + std::to_string(requiredSize) + " bytes");
-            return false;
-        }
+    uint32_t controlEnd = CONTROL_REGION_START + CONTROL_HEADER_BYTES +
+                          MODULATION_LANE_COUNT * bufferBytes +
+                          MAX_BLOCK_EVENTS * sizeof(DspEvent);
+    if (controlEnd > CAPTURE_RING_START) {
+        SUNA_LOG("WasmDSP: block size " + std::to_string(maxBlockSize) +
+                 " overruns the capture ring");
+        return false;
+    }
+    uint32_t requiredSize = CAPTURE_RING_START +
+                            2 * CAPTURE_RING_SAMPLES * sizeof(float);
+    uint64_t actualSize = backend_->getMemorySize();
+    if (actualSize < requiredSize) {
+        SUNA_LOG("WasmDSP: WASM memory too small: " + std::to_string(actualSize) + " bytes < required " + std::to_string(requiredSize) + " bytes");
+        return false;
     }
 
     leftInOffset_ = BUFFER_START;
@@ -251,6 +397,8 @@ bool WasmDSP::allocateBuffers(int maxBlockSize) {
     std::memset(nativeRightIn_, 0, bufferBytes);
     std::memset(nativeLeftOut_, 0, bufferBytes);
     std::memset(nativeRightOut_, 0, bufferBytes);
+    std::memset(memBase + CONTROL_REGION_START, 0,
+                CONTROL_HEADER_BYTES + MODULATION_LANE_COUNT * bufferBytes);
 
     maxBlockSize_ = maxBlockSize;
     
@@ -274,17 +422,27 @@ void WasmDSP::prepareToPlay(double sampleRate, int maxBlockSize) {
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    // Offline renders get a larger I/O region, so long host blocks take
+    // fewer WASM calls; either way it must end below the sample slots
+    if (nonRealtime_) {
+        maxBlockSize = std::max(maxBlockSize, NON_REALTIME_BLOCK_SIZE);
+    }
+    maxBlockSize = std::min(maxBlockSize, MAX_IO_BLOCK_SIZE);
+
+    TracedLock lock(wasmMutex_, __func__);
+    sampleRate_ = sampleRate;
+    loadMeter_.reset();
     if (!refreshMemoryBase()) {
         return;
     }
 
     if (prepared_ && maxBlockSize_ >= maxBlockSize) {
-        wasm_val_t args[1] = {
-            { .kind = WASM_F32, .of = { .f32 = static_cast<float>(sampleRate) } }
+        wasm_val_t args[2] = {
+            { .kind = WASM_F32, .of = { .f32 = static_cast<float>(sampleRate) } },
+            { .kind = WASM_I32, .of = { .i32 = grainPoolSize_ } }
         };
-        wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-        wasm_runtime_call_wasm_a(execEnv_, initSamplerFunc_, 1, results, 1, args);
+        backend_->call(DspExport::InitSampler, 2, args);
+        callWorkers(DspExport::InitSampler, 2, args);
         return;
     }
 
@@ -299,11 +457,12 @@ void WasmDSP::prepareToPlay(double sampleRate, int maxBlockSize) {
         return;
     }
 
-    wasm_val_t args[1] = {
-        { .kind = WASM_F32, .of = { .f32 = static_cast<float>(sampleRate) } }
+    wasm_val_t args[2] = {
+        { .kind = WASM_F32, .of = { .f32 = static_cast<float>(sampleRate) } },
+        { .kind = WASM_I32, .of = { .i32 = grainPoolSize_ } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, initSamplerFunc_, 1, results, 1, args);
+    backend_->call(DspExport::InitSampler, 2, args);
+    callWorkers(DspExport::InitSampler, 2, args);
 
     prepared_ = true;
     SUNA_LOG("WasmDSP::prepareToPlay() - Success, prepared_=true");
@@ -311,85 +470,122 @@ void WasmDSP::prepareToPlay(double sampleRate, int maxBlockSize) {
 
 void WasmDSP::processBlock(const float* leftIn, const float* rightIn,
                            float* leftOut, float* rightOut, int numSamples) {
-    static bool firstCall = true;
-    if (firstCall) {
-        SUNA_LOG("WasmDSP::processBlock() - First call with " + std::to_string(numSamples) + " samples");
-        firstCall = false;
-    }
+    // Queued events belong to this block only, whichever path it takes
+    struct ClearBlockEvents {
+        int& count;
+        ~ClearBlockEvents() { count = 0; }
+    } clearBlockEvents{numBlockEvents_};
+
+    // Time the whole call, dropped blocks included: the host waits for them too
+    struct RecordLoad {
+        DspLoadMeter& meter;
+        double blockSeconds;
+        std::chrono::steady_clock::time_point start;
+        ~RecordLoad() {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            meter.record(elapsed.count(), blockSeconds);
+        }
+    } recordLoad{loadMeter_, sampleRate_ > 0.0 ? numSamples / sampleRate_ : 0.0,
+                 std::chrono::steady_clock::now()};
+
+    // Offline, a complete render matters more than meeting a deadline
+    const bool nonRealtime = nonRealtime_.load(std::memory_order_relaxed);
+    RtCheck::Scope rtScope(!nonRealtime);
+
+    if (Trace::isEnabled()) Trace::setThreadName("audio");
+    TraceSpan processSpan("process_block");
+
+    // One-time setup of each audio thread (and its logging) may allocate
+    {
+        RtCheck::Disabler threadSetup;
+
+        static bool firstCall = true;
+        if (firstCall) {
+            SUNA_LOG("WasmDSP::processBlock() - First call with " + std::to_string(numSamples) + " samples");
+            firstCall = false;
+        }
     
-    // === THREAD ENV INITIALIZATION WITH DIAGNOSTICS ===
-    // WAMR requires thread env to be initialized on any thread calling WASM functions.
-    // processBlock runs on DAW's audio thread, different from main thread where
-    // wasm_runtime_full_init() was called.
-    //
-    // Known issue: On some builds, init() returns true but env_inited() stays false.
-    // This diagnostic code helps identify the root cause.
-    static thread_local bool threadEnvInitialized = false;
-    static thread_local int threadInitAttempts = 0;
+        // === THREAD ENV INITIALIZATION WITH DIAGNOSTICS ===
+        // WAMR requires thread env to be initialized on any thread calling WASM functions.
+        // processBlock runs on DAW's audio thread, different from main thread where
+        // wasm_runtime_full_init() was called.
+        //
+        // Known issue: On some builds, init() returns true but env_inited() stays false.
+        // This diagnostic code helps identify the root cause.
+        // The native backend runs no WASM, so its threads need no env.
+        static thread_local bool threadEnvInitialized = false;
+        static thread_local int threadInitAttempts = 0;
     
-    if (!threadEnvInitialized) {
-        threadInitAttempts++;
+        if (!threadEnvInitialized && backendType_ == DspBackendType::WamrAot) {
+            threadInitAttempts++;
         
-        // Get thread ID for logging (truncated for readability)
-        auto threadIdHash = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 10000;
+            // Get thread ID for logging (truncated for readability)
+            auto threadIdHash = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 10000;
         
-        bool envInitedBefore = wasm_runtime_thread_env_inited();
-        SUNA_LOG("WasmDSP DIAG: Thread " + std::to_string(threadIdHash) +
-            " - env_inited_before=" + std::string(envInitedBefore ? "true" : "false") +
-            " - attempt=" + std::to_string(threadInitAttempts));
+            bool envInitedBefore = wasm_runtime_thread_env_inited();
+            SUNA_LOG("WasmDSP DIAG: Thread " + std::to_string(threadIdHash) +
+                " - env_inited_before=" + std::string(envInitedBefore ? "true" : "false") +
+                " - attempt=" + std::to_string(threadInitAttempts));
         
-        if (!envInitedBefore) {
-            bool initResult = wasm_runtime_init_thread_env();
-            bool envInitedAfter = wasm_runtime_thread_env_inited();
+            if (!envInitedBefore) {
+                bool initResult = wasm_runtime_init_thread_env();
+                bool envInitedAfter = wasm_runtime_thread_env_inited();
             
-            SUNA_LOG("WasmDSP DIAG: Thread " + std::to_string(threadIdHash) +
-                " - init_result=" + std::string(initResult ? "true" : "false") +
-                " - env_inited_after=" + std::string(envInitedAfter ? "true" : "false"));
+                SUNA_LOG("WasmDSP DIAG: Thread " + std::to_string(threadIdHash) +
+                    " - init_result=" + std::string(initResult ? "true" : "false") +
+                    " - env_inited_after=" + std::string(envInitedAfter ? "true" : "false"));
             
-            if (!initResult) {
-                SUNA_LOG("WasmDSP DIAG: FATAL - init_thread_env returned false");
-                if (numSamples > 0) {
-                    size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
-                    std::memset(leftOut, 0, copyBytes);
-                    std::memset(rightOut, 0, copyBytes);
+                if (!initResult) {
+                    SUNA_LOG("WasmDSP DIAG: FATAL - init_thread_env returned false");
+                    if (numSamples > 0) {
+                        processedBlocks_.fetch_add(1, std::memory_order_relaxed);
+                        recordDrop(DropReason::ThreadEnvInit);
+                        size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
+                        std::memset(leftOut, 0, copyBytes);
+                        std::memset(rightOut, 0, copyBytes);
+                    }
+                    return;
                 }
-                return;
-            }
             
-            if (!envInitedAfter) {
-                // THIS IS THE KEY DIAGNOSTIC:
-                // If we reach here, init returned true but env_inited is still false.
-                // This confirms a TLS issue, symbol resolution problem, or library build issue.
-                SUNA_LOG("WasmDSP DIAG: ANOMALY - init=true but env_inited=false after init!");
+                if (!envInitedAfter) {
+                    // THIS IS THE KEY DIAGNOSTIC:
+                    // If we reach here, init returned true but env_inited is still false.
+                    // This confirms a TLS issue, symbol resolution problem, or library build issue.
+                    SUNA_LOG("WasmDSP DIAG: ANOMALY - init=true but env_inited=false after init!");
+                }
             }
+            threadEnvInitialized = true;
         }
-        threadEnvInitialized = true;
+        // === END THREAD ENV INITIALIZATION ===
     }
-    // === END THREAD ENV INITIALIZATION ===
 
-    // Handle uninitialized/unprepared state with passthrough
-    static bool passthroughLogged = false;
-    if (!prepared_ || numSamples <= 0 || numSamples > maxBlockSize_) {
-        if (!passthroughLogged) {
-            SUNA_LOG("WasmDSP::processBlock() - PASSTHROUGH MODE: prepared_=" +
-                std::string(prepared_.load() ? "true" : "false") + ", numSamples=" + std::to_string(numSamples) +
-                ", maxBlockSize_=" + std::to_string(maxBlockSize_));
-            passthroughLogged = true;
-        }
-        if (numSamples > 0) {
-            size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
-            std::memset(leftOut, 0, copyBytes);
-            std::memset(rightOut, 0, copyBytes);
+    if (numSamples <= 0) return;
+    processedBlocks_.fetch_add(1, std::memory_order_relaxed);
+
+    // Handle uninitialized/unprepared state with silence
+    if (!prepared_) {
+        if (recordDrop(DropReason::NotPrepared) == 1) {
+            SUNA_LOG("WasmDSP::processBlock() - PASSTHROUGH MODE: prepared_=false, numSamples=" +
+                std::to_string(numSamples) + ", maxBlockSize_=" + std::to_string(maxBlockSize_));
         }
+        size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
+        std::memset(leftOut, 0, copyBytes);
+        std::memset(rightOut, 0, copyBytes);
         return;
     }
 
-    std::unique_lock<std::recursive_mutex> lock(wasmMutex_, std::try_to_lock);
+    std::unique_lock<std::recursive_mutex> lock(wasmMutex_, std::defer_lock);
+    {
+        TraceSpan lockSpan("lock_wait");
+        if (nonRealtime) {
+            lock.lock();
+        } else {
+            lock.try_lock();
+        }
+    }
     if (!lock.owns_lock()) {
-        static bool lockContentionLogged = false;
-        if (!lockContentionLogged) {
+        if (recordDrop(DropReason::LockContention) == 1) {
             SUNA_LOG("WasmDSP::processBlock() - Skipping block: WASM busy");
-            lockContentionLogged = true;
         }
         size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
         std::memset(leftOut, 0, copyBytes);
@@ -398,70 +594,189 @@ void WasmDSP::processBlock(const float* leftIn, const float* rightIn,
     }
 
     if (!refreshMemoryBase()) {
+        recordDrop(DropReason::MemoryUnavailable);
         size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
         std::memset(leftOut, 0, copyBytes);
         std::memset(rightOut, 0, copyBytes);
         return;
     }
+    if (numSamples > maxBlockSize_) {
+        splitBlocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Render in chunks that fit the I/O region (or the fixed quantum), so
+    // blocks larger than announced in prepareToPlay still play
+    int quantum = nonRealtime ? 0 : processingQuantum_.load(std::memory_order_relaxed);
+    if (quantum <= 0 || quantum > maxBlockSize_) quantum = maxBlockSize_;
 
-    size_t copyBytes = static_cast<size_t>(numSamples) * sizeof(float);
+    // Event offsets are relative to the host block; clamping keeps them sorted
+    for (int i = 0; i < numBlockEvents_; ++i) {
+        blockEvents_[i].offset = std::clamp(blockEvents_[i].offset, 0, numSamples - 1);
+    }
+    int nextEvent = 0;
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += quantum) {
+        const int chunkSize = std::min(quantum, numSamples - chunkStart);
+        const size_t chunkBytes = static_cast<size_t>(chunkSize) * sizeof(float);
+        if (!processChunk(leftIn ? leftIn + chunkStart : nullptr,
+                          rightIn ? rightIn + chunkStart : nullptr,
+                          chunkStart, chunkSize, nextEvent)) {
+            const size_t restBytes = static_cast<size_t>(numSamples - chunkStart) * sizeof(float);
+            std::memset(leftOut + chunkStart, 0, restBytes);
+            std::memset(rightOut + chunkStart, 0, restBytes);
+            return;
+        }
+        std::memcpy(leftOut + chunkStart, nativeLeftOut_, chunkBytes);
+        std::memcpy(rightOut + chunkStart, nativeRightOut_, chunkBytes);
+    }
+}
+
+bool WasmDSP::processChunk(const float* leftIn, const float* rightIn,
+                           int chunkStart, int numSamples, int& nextEvent) {
+    // The DSP only reads the input while it records it for a live slot
+    if (liveInputSlot_.load(std::memory_order_relaxed) >= 0) {
+        TraceSpan stageSpan("stage_input");
+        stageInput(leftIn, rightIn, numSamples);
+    }
+
+    // Control header: which lanes the host filled, their capacity, this
+    // chunk's events and where the chunk starts in the lanes
+    auto* header = reinterpret_cast<int32_t*>(memBase_ + CONTROL_REGION_START);
+    header[0] = static_cast<int32_t>(modulationFlags_.load(std::memory_order_relaxed));
+    header[1] = maxBlockSize_;
+    {
+        TraceSpan drainSpan("drain_events");
+        header[2] = writeEventList(chunkStart, numSamples, nextEvent);
+    }
+    header[3] = chunkStart;
+
+    // Workers render their share of the grains while this thread renders
+    // its own. Small chunks are not worth the hand-off: this thread then
+    // renders every share, each on its worker's instance
+    const bool parallel = !workers_.empty() && numSamples >= MIN_PARALLEL_BLOCK_SIZE;
+    std::chrono::steady_clock::time_point claimDeadline;
+    if (!workers_.empty()) {
+        copyControlToWorkers(chunkStart, numSamples, header[2]);
+        workerChunkSamples_ = numSamples;
+    }
+    if (parallel) {
+        for (auto& worker : workers_) {
+            worker->share.store(ShareQueued, std::memory_order_release);
+        }
+        claimDeadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(WORKER_CLAIM_DEADLINE * numSamples / sampleRate_));
+        // Paired with the sleeping count: a worker about to sleep either
+        // sees the new generation or is counted here and notified
+        workGeneration_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepingWorkers_.load(std::memory_order_seq_cst) > 0) {
+            wakeCondition_.notify_all();
+        }
+    }
 
     wasm_val_t args[6] = {
-        { .kind = WASM_I32, .of = { .i32 = 0 } },
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(CONTROL_REGION_START) } },
         { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(leftInOffset_) } },
         { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(rightInOffset_) } },
         { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(leftOutOffset_) } },
         { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(rightOutOffset_) } },
         { .kind = WASM_I32, .of = { .i32 = numSamples } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = -999 } } };
-    bool success = wasm_runtime_call_wasm_a(execEnv_, processBlockFunc_, 1, results, 6, args);
-    
+    bool success;
+    {
+        TraceSpan callSpan("dsp_call");
+        success = backend_->call(DspExport::ProcessBlock, 6, args);
+    }
+
+    // Barrier: shares are summed once every one is rendered. A worker that
+    // has not claimed its share by the deadline loses it to this thread
+    bool sharesRendered = true;
+    if (parallel) {
+        sharesRendered = waitForShares(claimDeadline);
+    } else {
+        for (auto& worker : workers_) {
+            sharesRendered = renderShare(*worker) && sharesRendered;
+        }
+    }
+
     if (!success) {
-        const char* exception = wasm_runtime_get_exception(moduleInst_);
-        SUNA_LOG(std::string("WASM call failed: ") + (exception ? exception : "unknown error"));
-        
-        std::memset(leftOut, 0, copyBytes);
-        std::memset(rightOut, 0, copyBytes);
-        return;
+        const char* exception = backend_->getException();
+        if (recordDrop(DropReason::WasmException) == 1) {
+            SUNA_LOG(std::string("WASM call failed: ") + (exception ? exception : "unknown error"));
+            const std::string stack = backend_->getCallStack();
+            if (!stack.empty()) {
+                SUNA_LOG("WASM call stack:\n" + stack);
+            }
+        }
+        return false;
+    }
+
+    // The missing share cannot be rendered again: its instance has already
+    // advanced past this chunk
+    if (!sharesRendered) {
+        if (recordDrop(DropReason::WorkerException) == 1) {
+            SUNA_LOG("WasmDSP::processBlock() - Failed: a render worker's DSP call trapped");
+        }
+        return false;
     }
 
     if (!refreshMemoryBase() || !nativeLeftOut_ || !nativeRightOut_) {
-        SUNA_LOG("WasmDSP::processBlock() - Failed: output buffers unavailable");
-        std::memset(leftOut, 0, copyBytes);
-        std::memset(rightOut, 0, copyBytes);
-        return;
+        if (recordDrop(DropReason::MemoryUnavailable) == 1) {
+            SUNA_LOG("WasmDSP::processBlock() - Failed: output buffers unavailable");
+        }
+        return false;
     }
 
-    static int debugCounter = 0;
-    if (++debugCounter % 500 == 0) {
-        float maxSample = 0.0f;
-        for (int i = 0; i < numSamples; i++) {
-            float absVal = nativeLeftOut_[i] < 0 ? -nativeLeftOut_[i] : nativeLeftOut_[i];
-            if (absVal > maxSample) maxSample = absVal;
+    for (auto& worker : workers_) {
+        const auto* left = reinterpret_cast<const float*>(worker->memBase + leftOutOffset_);
+        const auto* right = reinterpret_cast<const float*>(worker->memBase + rightOutOffset_);
+        for (int i = 0; i < numSamples; ++i) {
+            nativeLeftOut_[i] += left[i];
+            nativeRightOut_[i] += right[i];
         }
-        
-        std::string slotInfo = "";
-        for (int s = 0; s < 8; s++) {
-            slotInfo += "s" + std::to_string(s) + "=" + std::to_string(getSlotLength(s)) + " ";
+    }
+    return true;
+}
+
+void WasmDSP::copyControlToWorkers(int chunkStart, int numSamples, int numEvents) {
+    const uint8_t* control = memBase_ + CONTROL_REGION_START;
+    const uint32_t flags = *reinterpret_cast<const uint32_t*>(control);
+    const size_t laneBytes = static_cast<size_t>(maxBlockSize_) * sizeof(float);
+    const size_t eventsOffset = CONTROL_HEADER_BYTES + MODULATION_LANE_COUNT * laneBytes;
+    // Only this chunk's slice of the enabled lanes (none past their capacity)
+    const int laneSamples = std::min(numSamples, maxBlockSize_ - chunkStart);
+
+    for (auto& worker : workers_) {
+        uint8_t* workerControl = worker->memBase + CONTROL_REGION_START;
+        std::memcpy(workerControl, control, CONTROL_HEADER_BYTES);
+        for (int lane = 0; lane < MODULATION_LANE_COUNT && laneSamples > 0; ++lane) {
+            if ((flags & (1u << lane)) == 0) continue;
+            const size_t offset = CONTROL_HEADER_BYTES + lane * laneBytes +
+                                  static_cast<size_t>(chunkStart) * sizeof(float);
+            std::memcpy(workerControl + offset, control + offset,
+                        static_cast<size_t>(laneSamples) * sizeof(float));
         }
-        
-        SUNA_LOG("DSP_OUT: peak=" + std::to_string(maxSample) + 
-                 " result=" + std::to_string(results[0].of.i32) +
-                 " | " + slotInfo);
-        
-        SUNA_LOG("DSP_ARGS: leftIn=" + std::to_string(leftInOffset_) +
-                 " rightIn=" + std::to_string(rightInOffset_) +
-                 " leftOut=" + std::to_string(leftOutOffset_) +
-                 " rightOut=" + std::to_string(rightOutOffset_) +
-                 " samples=" + std::to_string(numSamples));
-        
-        SUNA_LOG("DSP_PTR: nativeLeftOut=" + std::to_string(reinterpret_cast<uintptr_t>(nativeLeftOut_)) +
-                 " nativeSampleData=" + std::to_string(reinterpret_cast<uintptr_t>(nativeSampleData_)));
+        std::memcpy(workerControl + eventsOffset, control + eventsOffset,
+                    static_cast<size_t>(numEvents) * sizeof(DspEvent));
     }
+}
 
-    std::memcpy(leftOut, nativeLeftOut_, copyBytes);
-    std::memcpy(rightOut, nativeRightOut_, copyBytes);
+void WasmDSP::stageInput(const float* leftIn, const float* rightIn, int numSamples) {
+    const size_t bytes = static_cast<size_t>(numSamples) * sizeof(float);
+    // A mono input feeds both channels of the mix
+    if (!rightIn) rightIn = leftIn;
+    if (leftIn) {
+        std::memcpy(nativeLeftIn_, leftIn, bytes);
+        std::memcpy(nativeRightIn_, rightIn, bytes);
+    } else {
+        std::memset(nativeLeftIn_, 0, bytes);
+        std::memset(nativeRightIn_, 0, bytes);
+    }
+    // Every worker records the same ring, so its grains read the same input
+    for (auto& worker : workers_) {
+        std::memcpy(worker->memBase + leftInOffset_, nativeLeftIn_, bytes);
+        std::memcpy(worker->memBase + rightInOffset_, nativeRightIn_, bytes);
+    }
 }
 
 void WasmDSP::loadSample(int slot, const float* data, int length) {
@@ -475,7 +790,7 @@ void WasmDSP::loadSample(int slot, const float* data, int length) {
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     if (!refreshMemoryBase() || !nativeSampleData_) {
         SUNA_LOG("LOAD_SAMPLE_ABORT: no sample data ptr");
         return;
@@ -485,9 +800,28 @@ void WasmDSP::loadSample(int slot, const float* data, int length) {
     int copyLength = (length > MAX_SAMPLES_PER_SLOT) ? MAX_SAMPLES_PER_SLOT : length;
     
     uint32_t slotOffset = static_cast<uint32_t>(slot) * MAX_SAMPLES_PER_SLOT;
-    std::memcpy(nativeSampleData_ + slotOffset, data, static_cast<size_t>(copyLength) * sizeof(float));
-
     uint32_t dataPtr = SAMPLE_DATA_START + slotOffset * sizeof(float);
+
+    // Shared builds point the slot at the store's copy (same app address in
+    // every instance); otherwise each instance gets its own copy
+    std::shared_ptr<const SharedSample> shared;
+    {
+        TraceSpan copySpan("sample_copy");
+#if SUNA_SHARED_SAMPLES
+        if (sharedSamples_ && slot >= 0 && slot < MAX_SLOTS) {
+            shared = SampleStore::instance().acquire(data, copyLength);
+        }
+#endif
+        if (shared) {
+            dataPtr = static_cast<uint32_t>(shared->appOffset);
+        } else {
+            std::memcpy(nativeSampleData_ + slotOffset, data, static_cast<size_t>(copyLength) * sizeof(float));
+            for (auto& worker : workers_) {
+                auto* workerSamples = reinterpret_cast<float*>(worker->memBase + SAMPLE_DATA_START);
+                std::memcpy(workerSamples + slotOffset, data, static_cast<size_t>(copyLength) * sizeof(float));
+            }
+        }
+    }
     
     float firstSample = data[0];
     float lastSample = data[copyLength - 1];
@@ -509,26 +843,42 @@ void WasmDSP::loadSample(int slot, const float* data, int length) {
         { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(dataPtr) } },
         { .kind = WASM_I32, .of = { .i32 = copyLength } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = -999 } } };
-    bool success = wasm_runtime_call_wasm_a(execEnv_, loadSampleFunc_, 1, results, 3, args);
+    int32_t result = -999;
+    bool success = backend_->call(DspExport::LoadSample, 3, args, &result);
+    callWorkers(DspExport::LoadSample, 3, args);
+    // The previous entry is released only now that no instance reads it
+    if (slot >= 0 && slot < MAX_SLOTS) {
+        slotSamples_[slot] = shared;
+    }
+    // The DSP turned live input off for the sample
+    if (slot == liveInputSlot_.load()) {
+        liveInputSlot_ = -1;
+    }
     refreshMemoryBase();
     
     int slotLenAfter = getSlotLength(slot);
     
     SUNA_LOG("LOAD_SAMPLE_RESULT: success=" + std::string(success ? "true" : "false") +
-             " wasmResult=" + std::to_string(results[0].of.i32) +
+             " wasmResult=" + std::to_string(result) +
              " slotLengthAfter=" + std::to_string(slotLenAfter));
 }
 
 void WasmDSP::clearSlot(int slot) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
 
     wasm_val_t args[1] = {
         { .kind = WASM_I32, .of = { .i32 = slot } }
     };
-    wasm_runtime_call_wasm_a(execEnv_, clearSlotFunc_, 0, nullptr, 1, args);
+    backend_->call(DspExport::ClearSlot, 1, args);
+    callWorkers(DspExport::ClearSlot, 1, args);
+    if (slot >= 0 && slot < MAX_SLOTS) {
+        slotSamples_[slot].reset();
+    }
+    if (slot == liveInputSlot_.load()) {
+        liveInputSlot_ = -1;
+    }
 }
 
 void WasmDSP::playAll() {
@@ -538,8 +888,9 @@ void WasmDSP::playAll() {
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
-    wasm_runtime_call_wasm_a(execEnv_, playAllFunc_, 0, nullptr, 0, nullptr);
+    TracedLock lock(wasmMutex_, __func__);
+    backend_->call(DspExport::PlayAll, 0, nullptr);
+    callWorkers(DspExport::PlayAll, 0, nullptr);
     
     std::string slotInfo = "";
     for (int s = 0; s < 8; s++) {
@@ -552,14 +903,15 @@ void WasmDSP::stopAll() {
     SUNA_LOG("STOP_ALL called");
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
-    wasm_runtime_call_wasm_a(execEnv_, stopAllFunc_, 0, nullptr, 0, nullptr);
+    TracedLock lock(wasmMutex_, __func__);
+    backend_->call(DspExport::StopAll, 0, nullptr);
+    callWorkers(DspExport::StopAll, 0, nullptr);
 }
 
 void WasmDSP::setBlendX(float value) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static float lastLoggedX = -999.0f;
     if (std::abs(value - lastLoggedX) > 0.01f) {
@@ -570,14 +922,14 @@ void WasmDSP::setBlendX(float value) {
     wasm_val_t args[1] = {
         { .kind = WASM_F32, .of = { .f32 = value } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setBlendXFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetBlendX, 1, args);
+    callWorkers(DspExport::SetBlendX, 1, args);
 }
 
 void WasmDSP::setBlendY(float value) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static float lastLoggedY = -999.0f;
     if (std::abs(value - lastLoggedY) > 0.01f) {
@@ -588,14 +940,14 @@ void WasmDSP::setBlendY(float value) {
     wasm_val_t args[1] = {
         { .kind = WASM_F32, .of = { .f32 = value } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setBlendYFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetBlendY, 1, args);
+    callWorkers(DspExport::SetBlendY, 1, args);
 }
 
 void WasmDSP::setPlaybackSpeed(float speed) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static float lastLoggedSpeed = -999.0f;
     if (std::abs(speed - lastLoggedSpeed) > 0.01f) {
@@ -606,14 +958,14 @@ void WasmDSP::setPlaybackSpeed(float speed) {
     wasm_val_t args[1] = {
         { .kind = WASM_F32, .of = { .f32 = speed } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setPlaybackSpeedFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetPlaybackSpeed, 1, args);
+    callWorkers(DspExport::SetPlaybackSpeed, 1, args);
 }
 
 void WasmDSP::setGrainLength(int length) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static int lastLoggedLen = -999;
     if (length != lastLoggedLen) {
@@ -624,14 +976,14 @@ void WasmDSP::setGrainLength(int length) {
     wasm_val_t args[1] = {
         { .kind = WASM_I32, .of = { .i32 = length } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setGrainLengthFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetGrainLength, 1, args);
+    callWorkers(DspExport::SetGrainLength, 1, args);
 }
 
 void WasmDSP::setGrainDensity(float density) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static float lastLoggedDensity = -999.0f;
     if (std::abs(density - lastLoggedDensity) > 0.001f) {
@@ -642,14 +994,14 @@ void WasmDSP::setGrainDensity(float density) {
     wasm_val_t args[1] = {
         { .kind = WASM_F32, .of = { .f32 = density } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setGrainDensityFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetGrainDensity, 1, args);
+    callWorkers(DspExport::SetGrainDensity, 1, args);
 }
 
 void WasmDSP::setFreeze(int value) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static int lastLoggedFreeze = -999;
     if (value != lastLoggedFreeze) {
@@ -660,14 +1012,14 @@ void WasmDSP::setFreeze(int value) {
     wasm_val_t args[1] = {
         { .kind = WASM_I32, .of = { .i32 = value } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setFreezeFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetFreeze, 1, args);
+    callWorkers(DspExport::SetFreeze, 1, args);
 }
 
 void WasmDSP::setSpeedTarget(float target) {
     if (!initialized_) return;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
     
     static float lastLoggedTarget = -999.0f;
     if (std::abs(target - lastLoggedTarget) > 0.01f) {
@@ -678,74 +1030,472 @@ void WasmDSP::setSpeedTarget(float target) {
     wasm_val_t args[1] = {
         { .kind = WASM_F32, .of = { .f32 = target } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, setSpeedTargetFunc_, 1, results, 1, args);
+    backend_->call(DspExport::SetSpeedTarget, 1, args);
+    callWorkers(DspExport::SetSpeedTarget, 1, args);
+}
+
+void WasmDSP::setInterpolation(int mode) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    SUNA_LOG("SET_INTERPOLATION: " + std::to_string(mode));
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_I32, .of = { .i32 = mode } }
+    };
+    backend_->call(DspExport::SetInterpolation, 1, args);
+    callWorkers(DspExport::SetInterpolation, 1, args);
+}
+
+int WasmDSP::setGrainPoolSize(int size) {
+    TracedLock lock(wasmMutex_, __func__);
+
+    grainPoolSize_ = std::clamp(size, MIN_GRAIN_POOL_SIZE, MAX_GRAIN_POOL_SIZE);
+    SUNA_LOG("SET_GRAIN_POOL_SIZE: " + std::to_string(grainPoolSize_));
+    return grainPoolSize_;
+}
+
+void WasmDSP::setGrainJitter(float amount) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_F32, .of = { .f32 = amount } }
+    };
+    backend_->call(DspExport::SetGrainJitter, 1, args);
+    callWorkers(DspExport::SetGrainJitter, 1, args);
+}
+
+void WasmDSP::setMaxOverlap(int count) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_I32, .of = { .i32 = count } }
+    };
+    backend_->call(DspExport::SetMaxOverlap, 1, args);
+    callWorkers(DspExport::SetMaxOverlap, 1, args);
+}
+
+void WasmDSP::setLiveInput(int slot) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_I32, .of = { .i32 = slot } }
+    };
+    int32_t result = -1;
+    const bool success = backend_->call(DspExport::SetLiveInput, 1, args, &result);
+    callWorkers(DspExport::SetLiveInput, 1, args);
+    if (success && result == 0) {
+        if (slot >= 0 && slot < MAX_SLOTS) {
+            slotSamples_[slot].reset();
+        }
+        liveInputSlot_ = slot;
+    }
+}
+
+void WasmDSP::setCaptureDelay(int samples) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_I32, .of = { .i32 = samples } }
+    };
+    backend_->call(DspExport::SetCaptureDelay, 1, args);
+    callWorkers(DspExport::SetCaptureDelay, 1, args);
+}
+
+void WasmDSP::setCaptureWindow(int samples) {
+    if (!initialized_) return;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    wasm_val_t args[1] = {
+        { .kind = WASM_I32, .of = { .i32 = samples } }
+    };
+    backend_->call(DspExport::SetCaptureWindow, 1, args);
+    callWorkers(DspExport::SetCaptureWindow, 1, args);
+}
+
+bool WasmDSP::queueEvent(int sampleOffset, EventType type, float value, int data) {
+    if (numBlockEvents_ >= MAX_BLOCK_EVENTS) return false;
+
+    // Keep the list sorted by offset (events at one offset keep their order)
+    int i = numBlockEvents_;
+    while (i > 0 && blockEvents_[i - 1].offset > sampleOffset) {
+        blockEvents_[i] = blockEvents_[i - 1];
+        --i;
+    }
+    blockEvents_[i] = { sampleOffset, static_cast<int32_t>(type), value, data };
+    ++numBlockEvents_;
+    return true;
+}
+
+bool WasmDSP::postEvent(EventType type, float value) {
+    switch (type) {
+        case EventType::PlayAll:
+        case EventType::StopAll:
+        case EventType::NoteOn:
+        case EventType::NoteOff:
+        case EventType::AllNotesOff:
+            return false;
+        default:
+            break;
+    }
+    const int index = static_cast<int>(type);
+    if (index < 0 || index >= POSTED_EVENT_TYPES) return false;
+
+    postedValues_[index].store(value, std::memory_order_relaxed);
+    postedTypes_.fetch_or(1u << index, std::memory_order_release);
+    return true;
+}
+
+int WasmDSP::writeEventList(int chunkStart, int numSamples, int& nextEvent) {
+    const uint32_t laneBytes = static_cast<uint32_t>(maxBlockSize_) * sizeof(float);
+    auto* records = reinterpret_cast<DspEvent*>(
+        memBase_ + CONTROL_REGION_START + CONTROL_HEADER_BYTES +
+        MODULATION_LANE_COUNT * laneBytes);
+    int count = 0;
+
+    // Posted events apply at the block start, before this block's own events
+    if (chunkStart == 0) {
+        // A value posted during the loop sets its bit again; it is applied
+        // now and again next block, which is harmless for a parameter
+        const uint32_t types = postedTypes_.exchange(0, std::memory_order_acquire);
+        for (int type = 0; type < POSTED_EVENT_TYPES; ++type) {
+            if (types & (1u << type)) {
+                records[count++] = { 0, type, postedValues_[type].load(std::memory_order_relaxed), 0 };
+            }
+        }
+    }
+
+    // Block events inside this chunk, made relative to its start
+    const int chunkEnd = chunkStart + numSamples;
+    while (nextEvent < numBlockEvents_ && blockEvents_[nextEvent].offset < chunkEnd &&
+           count < MAX_BLOCK_EVENTS) {
+        DspEvent event = blockEvents_[nextEvent++];
+        event.offset -= chunkStart;
+        records[count++] = event;
+    }
+    return count;
+}
+
+float* WasmDSP::getModulationBuffer(ModulationLane lane) {
+    if (!prepared_ || !memBase_) return nullptr;
+
+    const uint32_t laneBytes = static_cast<uint32_t>(maxBlockSize_) * sizeof(float);
+    const uint32_t offset = CONTROL_REGION_START + CONTROL_HEADER_BYTES +
+                            static_cast<uint32_t>(lane) * laneBytes;
+    return reinterpret_cast<float*>(memBase_ + offset);
+}
+
+void WasmDSP::setModulationEnabled(ModulationLane lane, bool enabled) {
+    const uint32_t bit = 1u << static_cast<uint32_t>(lane);
+    if (enabled) {
+        modulationFlags_.fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        modulationFlags_.fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+void WasmDSP::setProcessingQuantum(int samples) {
+    processingQuantum_.store(samples > 0 ? samples : 0, std::memory_order_relaxed);
+}
+
+void WasmDSP::setNonRealtime(bool nonRealtime) {
+    nonRealtime_.store(nonRealtime);
+}
+
+DspStats WasmDSP::getStats() const {
+    DspStats stats;
+    stats.blocks = processedBlocks_.load(std::memory_order_relaxed);
+    stats.splitBlocks = splitBlocks_.load(std::memory_order_relaxed);
+    stats.lateWorkerShares = lateWorkerShares_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < stats.dropped.size(); ++i) {
+        stats.dropped[i] = droppedBlocks_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void WasmDSP::setDropCallback(DropCallback callback, void* context) {
+    dropCallback_ = callback;
+    dropCallbackContext_ = context;
+}
+
+bool WasmDSP::getProfile(std::vector<FunctionProfile>& functions) {
+    TracedLock lock(wasmMutex_, __func__);
+    functions.clear();
+    if (!backend_ || !backend_->getProfile(functions)) {
+        return false;
+    }
+    std::vector<FunctionProfile> workerFunctions;
+    for (auto& worker : workers_) {
+        if (!worker->backend->getProfile(workerFunctions)) continue;
+        for (auto& workerFunction : workerFunctions) {
+            auto match = std::find_if(functions.begin(), functions.end(),
+                [&](const FunctionProfile& f) { return f.name == workerFunction.name; });
+            if (match == functions.end()) {
+                functions.push_back(std::move(workerFunction));
+            } else {
+                match->totalMs += workerFunction.totalMs;
+                match->selfMs += workerFunction.selfMs;
+                match->calls += workerFunction.calls;
+            }
+        }
+    }
+    std::sort(functions.begin(), functions.end(),
+              [](const FunctionProfile& a, const FunctionProfile& b) { return a.selfMs > b.selfMs; });
+    return true;
+}
+
+uint64_t WasmDSP::recordDrop(DropReason reason) {
+    const uint64_t count =
+        droppedBlocks_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed) + 1;
+    Trace::instant(DROP_TRACE_NAMES[static_cast<size_t>(reason)]);
+    if (dropCallback_) {
+        dropCallback_(reason, count, dropCallbackContext_);
+    }
+    return count;
+}
+
+bool WasmDSP::startWorkers(int count) {
+    for (int i = 0; i < count; ++i) {
+        std::string error;
+        auto backend = createBackend(error);
+        if (!backend) {
+            SUNA_LOG("WasmDSP::startWorkers() - Failed: " + error);
+            return false;
+        }
+        auto worker = std::make_unique<RenderWorker>();
+        worker->backend = std::move(backend);
+        worker->memBase = worker->backend->getMemoryBase();
+        bool ready = worker->memBase != nullptr;
+#if SUNA_SHARED_SAMPLES
+        // Slots point at store addresses, which the worker must read too
+        if (ready && sharedSamples_ && !sampleHeap_->attach(worker->backend->getModuleInstance())) {
+            SUNA_LOG("WasmDSP::startWorkers() - Failed: shared sample heap not attached");
+            ready = false;
+        }
+#endif
+        if (ready) {
+            setRenderPartition(*worker->backend, i + 1, count + 1);
+        }
+        // Owned by workers_ from here, so stopWorkers() releases it on failure
+        workers_.push_back(std::move(worker));
+        if (!ready) {
+            SUNA_LOG("WasmDSP::startWorkers() - Failed: worker instance incomplete");
+            return false;
+        }
+    }
+
+    stopWorkers_.store(false);
+    // Read before the threads start: a block queued before a worker first
+    // runs must still count as new work for it, or the barrier never clears
+    const uint32_t generation = workGeneration_.load(std::memory_order_acquire);
+    for (auto& worker : workers_) {
+        RenderWorker* w = worker.get();
+        worker->thread = std::thread([this, w, generation] { workerLoop(*w, generation); });
+    }
+    SUNA_LOG("WasmDSP::startWorkers() - " + std::to_string(count) + " render workers");
+    return true;
+}
+
+void WasmDSP::stopWorkers() {
+    if (workers_.empty()) return;
+
+    stopWorkers_.store(true, std::memory_order_release);
+    workGeneration_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCondition_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+#if SUNA_SHARED_SAMPLES
+        if (sampleHeap_) {
+            sampleHeap_->detach(worker->backend->getModuleInstance());
+        }
+#endif
+    }
+    workers_.clear();
+    stopWorkers_.store(false);
+}
+
+void WasmDSP::workerLoop(RenderWorker& worker, uint32_t seen) {
+    const bool wamr = backendType_ == DspBackendType::WamrAot;
+    if (wamr) {
+        wasm_runtime_init_thread_env();
+    }
+
+    bool spin = true;
+    while (true) {
+        // Stay responsive while chunks keep coming, sleep when idle
+        uint32_t generation = workGeneration_.load(std::memory_order_acquire);
+        for (int polls = 0; spin && generation == seen && polls < WORKER_SPIN_LIMIT; ++polls) {
+            cpuRelax();
+            generation = workGeneration_.load(std::memory_order_acquire);
+        }
+        if (generation == seen) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+            wakeCondition_.wait_for(lock, WORKER_SLEEP_LIMIT, [&] {
+                generation = workGeneration_.load(std::memory_order_seq_cst);
+                return generation != seen;
+            });
+            sleepingWorkers_.fetch_sub(1, std::memory_order_relaxed);
+            // Still idle: sleep again without spinning
+            spin = generation != seen;
+            if (!spin) continue;
+        }
+        seen = generation;
+        if (stopWorkers_.load(std::memory_order_acquire)) break;
+
+        // The share is gone if the audio thread took it at its deadline
+        int expected = ShareQueued;
+        if (!worker.share.compare_exchange_strong(expected, ShareRendering,
+                                                  std::memory_order_acq_rel)) {
+            continue;
+        }
+        {
+            // The share is part of the audio callback's deadline
+            RtCheck::Scope rtScope(!nonRealtime_.load(std::memory_order_relaxed));
+            if (Trace::isEnabled()) Trace::setThreadName("render_worker");
+            TraceSpan renderSpan("worker_render");
+            renderShare(worker);
+        }
+        worker.share.store(ShareDone, std::memory_order_release);
+    }
+
+    if (wamr) {
+        wasm_runtime_destroy_thread_env();
+    }
+}
+
+bool WasmDSP::renderShare(RenderWorker& worker) {
+    wasm_val_t args[6] = {
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(CONTROL_REGION_START) } },
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(leftInOffset_) } },
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(rightInOffset_) } },
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(leftOutOffset_) } },
+        { .kind = WASM_I32, .of = { .i32 = static_cast<int32_t>(rightOutOffset_) } },
+        { .kind = WASM_I32, .of = { .i32 = workerChunkSamples_ } }
+    };
+    worker.failed = !worker.backend->call(DspExport::ProcessBlock, 6, args);
+    return !worker.failed;
+}
+
+bool WasmDSP::waitForShares(std::chrono::steady_clock::time_point claimDeadline) {
+    TraceSpan barrierSpan("worker_wait");
+    bool rendered = true;
+    for (auto& worker : workers_) {
+        int state = worker->share.load(std::memory_order_acquire);
+        while (state != ShareDone) {
+            // A claimed share is being rendered on its instance, so wait
+            if (state == ShareQueued && std::chrono::steady_clock::now() >= claimDeadline &&
+                worker->share.compare_exchange_strong(state, ShareRendering,
+                                                      std::memory_order_acq_rel)) {
+                TraceSpan lateSpan("late_share_render");
+                lateWorkerShares_.fetch_add(1, std::memory_order_relaxed);
+                renderShare(*worker);
+                worker->share.store(ShareDone, std::memory_order_relaxed);
+                break;
+            }
+            cpuRelax();
+            state = worker->share.load(std::memory_order_acquire);
+        }
+        rendered = rendered && !worker->failed;
+    }
+    return rendered;
+}
+
+void WasmDSP::setRenderPartition(DspBackend& backend, int index, int count) {
+    wasm_val_t args[2] = {
+        { .kind = WASM_I32, .of = { .i32 = index } },
+        { .kind = WASM_I32, .of = { .i32 = count } }
+    };
+    backend.call(DspExport::SetRenderPartition, 2, args);
+}
+
+void WasmDSP::callWorkers(DspExport function, uint32_t numArgs, wasm_val_t* args) {
+    for (auto& worker : workers_) {
+        worker->backend->call(function, numArgs, args);
+    }
+}
+
+int64_t WasmDSP::getAllocationCount() {
+    if (!initialized_) return -1;
+
+    TracedLock lock(wasmMutex_, __func__);
+
+    int32_t count = 0;
+    if (!backend_->call(DspExport::GetAllocationCount, 0, nullptr, &count)) return -1;
+    int64_t total = count;
+    for (auto& worker : workers_) {
+        if (!worker->backend->call(DspExport::GetAllocationCount, 0, nullptr, &count)) return -1;
+        total += count;
+    }
+    return total;
 }
 
 int WasmDSP::getSlotLength(int slot) {
     if (!initialized_) return 0;
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
 
     wasm_val_t args[1] = {
         { .kind = WASM_I32, .of = { .i32 = slot } }
     };
-    wasm_val_t results[1] = { { .kind = WASM_I32, .of = { .i32 = 0 } } };
-    wasm_runtime_call_wasm_a(execEnv_, getSlotLengthFunc_, 1, results, 1, args);
-    return results[0].of.i32;
+    int32_t result = 0;
+    backend_->call(DspExport::GetSlotLength, 1, args, &result);
+    return result;
 }
 
 void WasmDSP::shutdown() {
     // Clear flags FIRST to prevent audio thread from accessing resources during destruction
-    const bool wasInitialized = initialized_.exchange(false);
+    initialized_.store(false);
     prepared_.store(false);
 
-    std::lock_guard<std::recursive_mutex> lock(wasmMutex_);
+    TracedLock lock(wasmMutex_, __func__);
 
-    if (execEnv_) {
-        wasm_runtime_destroy_exec_env(execEnv_);
-        execEnv_ = nullptr;
+    for (auto& sample : slotSamples_) {
+        sample.reset();
     }
+    stopWorkers();
 
-    if (moduleInst_) {
-        wasm_runtime_deinstantiate(moduleInst_);
-        moduleInst_ = nullptr;
+#if SUNA_SHARED_SAMPLES
+    if (backend_ && sampleHeap_) {
+        sampleHeap_->detach(backend_->getModuleInstance());
     }
+    sharedSamples_ = false;
+#endif
+    backend_.reset();
 
     if (module_) {
         wasm_runtime_unload(module_);
         module_ = nullptr;
     }
 
-    if (wasInitialized) {
-        wasm_runtime_destroy();
-    }
+    releaseRuntime();
 
     if (aotDataCopy_) {
         std::free(aotDataCopy_);
         aotDataCopy_ = nullptr;
     }
 
-    initSamplerFunc_ = nullptr;
-    loadSampleFunc_ = nullptr;
-    clearSlotFunc_ = nullptr;
-    playAllFunc_ = nullptr;
-    stopAllFunc_ = nullptr;
-    getSlotLengthFunc_ = nullptr;
-    processBlockFunc_ = nullptr;
-    setBlendXFunc_ = nullptr;
-    setBlendYFunc_ = nullptr;
-    setPlaybackSpeedFunc_ = nullptr;
-    setGrainLengthFunc_ = nullptr;
-    setGrainDensityFunc_ = nullptr;
-    setFreezeFunc_ = nullptr;
-    setSpeedTargetFunc_ = nullptr;
-
     leftInOffset_ = rightInOffset_ = leftOutOffset_ = rightOutOffset_ = 0;
     nativeLeftIn_ = nativeRightIn_ = nativeLeftOut_ = nativeRightOut_ = nullptr;
     nativeSampleData_ = nullptr;
     memBase_ = nullptr;
     maxBlockSize_ = 0;
+    liveInputSlot_ = -1;
     aotDataSize_ = 0;
 }
 
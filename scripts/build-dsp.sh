@@ -40,7 +40,16 @@ if [ ! -f "$WAMRC" ]; then
   echo "Web build will work without AOT, but JUCE plugin requires it."
 else
   mkdir -p "$PLUGIN_RESOURCES"
-  "$WAMRC" --opt-level=3 -o "$PLUGIN_RESOURCES/suna_dsp.aot" "$UI_PUBLIC_WASM/suna_dsp.wasm"
+  # SUNA_SHARED_SAMPLES=1: slots may point into the process-wide shared heap
+  WAMRC_FLAGS=(--opt-level=3)
+  if [ "${SUNA_SHARED_SAMPLES:-0}" = "1" ]; then
+    WAMRC_FLAGS+=(--enable-shared-heap)
+  fi
+  # SUNA_WASM_PROFILING=1: per-function timing and trap call stacks (slower)
+  if [ "${SUNA_WASM_PROFILING:-0}" = "1" ]; then
+    WAMRC_FLAGS+=(--enable-perf-profiling --enable-dump-call-stack)
+  fi
+  "$WAMRC" "${WAMRC_FLAGS[@]}" -o "$PLUGIN_RESOURCES/suna_dsp.aot" "$UI_PUBLIC_WASM/suna_dsp.wasm"
 
   if [ ! -f "$PLUGIN_RESOURCES/suna_dsp.aot" ]; then
     echo "ERROR: AOT compilation failed - suna_dsp.aot not found"
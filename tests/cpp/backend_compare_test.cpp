@@ -0,0 +1,195 @@
+#define CATCH_CONFIG_MAIN
+#include "include/catch_amalgamated.hpp"
+#include "RenderScript.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Backend comparison: the same scripted renders through the WAMR AOT module
+// and through NativeDSP. The two run the same algorithm, so their outputs
+// must agree; they are not bit-exact because NativeDSP uses libm for
+// sin/cos/pow where the module has MoonBit's own. The render times are
+// printed so the cost of the WASM boundary can be tracked.
+
+namespace {
+
+struct CompareScenario {
+    const char* name;
+    const char* script;
+    int slots;
+    int blockSize;
+    bool liveInput;
+};
+
+std::vector<uint8_t> loadAOTFile(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+    auto size = file.tellg();
+    file.seekg(0);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+/** Fixed slot content: a few partials per slot, no randomness */
+std::vector<float> compareSlot(int slot) {
+    std::vector<float> sample(96000);
+    constexpr double twoPi = 6.283185307179586;
+    const double base = 110.0 * (slot + 2);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        const double t = static_cast<double>(i) / 48000.0;
+        sample[i] = static_cast<float>(0.4 * std::sin(twoPi * base * t) +
+                                       0.2 * std::sin(twoPi * base * 2.01 * t));
+    }
+    return sample;
+}
+
+struct Render {
+    std::vector<float> left;
+    std::vector<float> right;
+    double ms = 0.0;
+};
+
+Render render(const std::vector<uint8_t>& aot, const CompareScenario& scenario,
+              suna::DspBackendType backend) {
+    suna::RenderScript script;
+    std::string error;
+    const bool parsed = suna::RenderScript::parse(scenario.script, 48000.0, script, error);
+    INFO(error);
+    REQUIRE(parsed);
+
+    suna::RenderOptions options;
+    options.blockSize = scenario.blockSize;
+    options.backend = backend;
+    for (int slot = 0; slot < scenario.slots; ++slot) {
+        options.slots[slot] = compareSlot(slot);
+    }
+    if (scenario.liveInput) {
+        options.inputLeft = compareSlot(6);
+        options.inputRight = compareSlot(7);
+    }
+
+    suna::RenderResult result;
+    const bool rendered = suna::renderScript(aot, script, options, result);
+    INFO(suna::getBackendName(backend) << ": " << result.error);
+    REQUIRE(rendered);
+
+    Render out;
+    for (double ns : result.blockNs) out.ms += ns / 1e6;
+    out.left = std::move(result.left);
+    out.right = std::move(result.right);
+    return out;
+}
+
+void checkBackendsAgree(const CompareScenario& scenario) {
+    const auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(!aot.empty());
+
+    const auto wamr = render(aot, scenario, suna::DspBackendType::WamrAot);
+    const auto native = render(aot, scenario, suna::DspBackendType::Native);
+    REQUIRE(wamr.left.size() == native.left.size());
+
+    double signal = 0.0, noise = 0.0;
+    float maxAbsError = 0.0f;
+    auto accumulate = [&](const std::vector<float>& expected, const std::vector<float>& actual) {
+        for (size_t i = 0; i < expected.size(); ++i) {
+            const float error = std::abs(actual[i] - expected[i]);
+            signal += static_cast<double>(expected[i]) * expected[i];
+            noise += static_cast<double>(error) * error;
+            maxAbsError = std::max(maxAbsError, error);
+        }
+    };
+    accumulate(wamr.left, native.left);
+    accumulate(wamr.right, native.right);
+    const double snrDb = noise > 0.0 ? 10.0 * std::log10(signal / noise) : INFINITY;
+
+    std::printf("%-18s wamr %8.2f ms  native %8.2f ms  wamr/native %.2fx  "
+                "max abs error %.3g  SNR %.1f dB\n",
+                scenario.name, wamr.ms, native.ms,
+                native.ms > 0.0 ? wamr.ms / native.ms : 0.0, maxAbsError, snrDb);
+
+    INFO(scenario.name << ": SNR " << snrDb << " dB, max abs error " << maxAbsError);
+    CHECK(signal > 0.0);
+    CHECK(maxAbsError <= 1e-4f);
+    CHECK(snrDb >= 80.0);
+}
+
+const CompareScenario CLOUD = {
+    "cloud",
+    "0 grain_length 2400\n"
+    "0 density 0.8\n"
+    "0 speed 1.0\n"
+    "0 blend_x 0.3\n"
+    "0.5 blend_y 0.7\n"
+    "1.0 end\n",
+    4, 256, false
+};
+
+const CompareScenario CLOUD_SINC = {
+    "cloud_sinc",
+    "0 interpolation 3\n"
+    "0 grain_length 4224\n"
+    "0 density 1.0\n"
+    "0 speed 0.73\n"
+    "0.3 speed_target 1.4\n"
+    "1.0 end\n",
+    4, 128, false
+};
+
+const CompareScenario FROZEN = {
+    "frozen",
+    "0 grain_length 4800\n"
+    "0 density 0.6\n"
+    "0 speed 0.5\n"
+    "0.25 freeze 1\n"
+    "1.0 freeze 0\n"
+    "1.25 end\n",
+    2, 512, false
+};
+
+const CompareScenario NOTES = {
+    "notes",
+    "0 grain_length 1200\n"
+    "1000smp note_on 60 0.8\n"
+    "9000smp note_on 67 0.5\n"
+    "0.5 note_off 60\n"
+    "0.75 all_notes_off\n"
+    "1.0 end\n",
+    1, 64, false
+};
+
+const CompareScenario LIVE_INPUT = {
+    "live_input",
+    "0 live_input 0\n"
+    "0 grain_length 2400\n"
+    "0 density 0.7\n"
+    "0.5 blend_x 0.5\n"
+    "1.0 end\n",
+    0, 256, true
+};
+
+} // namespace
+
+TEST_CASE("Backends agree: density cloud", "[backend]") {
+    checkBackendsAgree(CLOUD);
+}
+
+TEST_CASE("Backends agree: sinc interpolation with a speed ramp", "[backend]") {
+    checkBackendsAgree(CLOUD_SINC);
+}
+
+TEST_CASE("Backends agree: freeze and release", "[backend]") {
+    checkBackendsAgree(FROZEN);
+}
+
+TEST_CASE("Backends agree: note voices", "[backend]") {
+    checkBackendsAgree(NOTES);
+}
+
+TEST_CASE("Backends agree: live input", "[backend]") {
+    checkBackendsAgree(LIVE_INPUT);
+}
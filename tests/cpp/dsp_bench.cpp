@@ -0,0 +1,148 @@
+#include "dsp_bench.h"
+#include "suna/WasmDSP.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace suna {
+namespace bench {
+
+namespace {
+
+constexpr int SLOT_SECONDS = 10;
+
+/** Deterministic slot content: a partial of its own plus a little noise */
+std::vector<float> makeSlotSample(int slot, double sampleRate) {
+    const int length = static_cast<int>(sampleRate) * SLOT_SECONDS;
+    std::vector<float> sample(static_cast<size_t>(length));
+    const double freq = 110.0 * (slot + 1);
+    uint32_t seed = 0x9e3779b9u + static_cast<uint32_t>(slot);
+    for (int i = 0; i < length; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+        sample[static_cast<size_t>(i)] = 0.5f * static_cast<float>(
+            std::sin(2.0 * 3.141592653589793 * freq * i / sampleRate)) + 0.05f * noise;
+    }
+    return sample;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<uint8_t> loadAOTFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+    auto size = file.tellg();
+    file.seekg(0);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+Result runScenario(const std::vector<uint8_t>& aot, const Scenario& scenario) {
+    Result result;
+    result.scenario = scenario;
+
+    WasmDSP dsp;
+    if (!dsp.initialize(aot.data(), aot.size(), scenario.renderThreads, scenario.backend)) {
+        return result;
+    }
+    if (scenario.grainPoolSize > 0) dsp.setGrainPoolSize(scenario.grainPoolSize);
+    const int blockSize = scenario.blockSize;
+    dsp.prepareToPlay(scenario.sampleRate, blockSize);
+    if (scenario.maxOverlap > 0) dsp.setMaxOverlap(scenario.maxOverlap);
+    for (int slot = 0; slot < scenario.slots; ++slot) {
+        const auto sample = makeSlotSample(slot, scenario.sampleRate);
+        dsp.loadSample(slot, sample.data(), static_cast<int>(sample.size()));
+    }
+    dsp.setGrainLength(scenario.grainLength);
+    dsp.setGrainDensity(scenario.density);
+    dsp.setPlaybackSpeed(scenario.speed);
+    dsp.setInterpolation(scenario.interpolation);
+
+    std::vector<float> in(static_cast<size_t>(blockSize), 0.0f);
+    std::vector<float> leftOut(static_cast<size_t>(blockSize));
+    std::vector<float> rightOut(static_cast<size_t>(blockSize));
+
+    // Warm-up: fill the cloud. Freezing stops the spawns, so a frozen
+    // scenario freezes the filled cloud and warms up again to build the
+    // loop cache
+    const int warmupBlocks = static_cast<int>(std::ceil(scenario.sampleRate / blockSize));
+    for (int pass = 0; pass < (scenario.freeze ? 2 : 1); ++pass) {
+        if (pass == 1) dsp.setFreeze(1);
+        for (int i = 0; i < warmupBlocks; ++i) {
+            dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), blockSize);
+        }
+    }
+
+    const int blocks = std::max(1, static_cast<int>(
+        std::ceil(scenario.seconds * scenario.sampleRate / blockSize)));
+    std::vector<double> blockUs;
+    blockUs.reserve(static_cast<size_t>(blocks));
+    double totalNs = 0.0;
+    for (int i = 0; i < blocks; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), blockSize);
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        totalNs += ns;
+        blockUs.push_back(ns / 1000.0);
+    }
+    dsp.shutdown();
+
+    std::sort(blockUs.begin(), blockUs.end());
+    const double samples = static_cast<double>(blocks) * blockSize;
+    result.blocks = blocks;
+    result.nsPerSample = totalNs / samples;
+    result.realtimeFactor = totalNs > 0.0 ? (samples / scenario.sampleRate) * 1e9 / totalNs : 0.0;
+    result.p50Us = percentile(blockUs, 0.50);
+    result.p99Us = percentile(blockUs, 0.99);
+    result.maxUs = blockUs.back();
+    result.budgetUs = blockSize * 1e6 / scenario.sampleRate;
+    result.ok = true;
+    return result;
+}
+
+std::string toJson(const std::vector<Result>& results) {
+    std::string json = "{\n  \"scenarios\": [\n";
+    char line[1024];
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        const auto& s = r.scenario;
+        std::snprintf(line, sizeof(line),
+            "    { \"name\": \"%s\", \"backend\": \"%s\", \"ok\": %s, "
+            "\"density\": %.3f, \"grain_length\": %d, \"slots\": %d, \"speed\": %.3f, "
+            "\"interpolation\": %d, \"freeze\": %s, \"block_size\": %d, \"render_threads\": %d, "
+            "\"sample_rate\": %.0f, \"blocks\": %d, "
+            "\"ns_per_sample\": %.3f, \"realtime_factor\": %.2f, "
+            "\"p50_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"budget_us\": %.3f }%s\n",
+            escape(s.name).c_str(), getBackendName(s.backend), r.ok ? "true" : "false",
+            s.density, s.grainLength, s.slots, s.speed, s.interpolation,
+            s.freeze ? "true" : "false", s.blockSize, s.renderThreads, s.sampleRate, r.blocks,
+            r.nsPerSample, r.realtimeFactor, r.p50Us, r.p99Us, r.maxUs, r.budgetUs,
+            i + 1 < results.size() ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+} // namespace bench
+} // namespace suna
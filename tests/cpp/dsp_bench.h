@@ -0,0 +1,56 @@
+#pragma once
+
+#include "suna/DspBackend.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace suna {
+namespace bench {
+
+/** One grain workload rendered through WasmDSP::processBlock */
+struct Scenario {
+    std::string name;
+    float density = 0.5f;
+    int grainLength = 4224;     // samples
+    int slots = 4;              // synthetic samples loaded through loadSample
+    float speed = 1.0f;
+    int interpolation = 2;      // 0 nearest, 1 linear, 2 cubic Hermite, 3 windowed sinc
+    bool freeze = false;
+    int blockSize = 256;
+    int renderThreads = 1;      // WasmDSP render instances
+    int grainPoolSize = 0;      // 0 = the DSP's default pool
+    int maxOverlap = 0;         // 0 = the DSP's default cap
+    double sampleRate = 48000.0;
+    double seconds = 5.0;       // audio rendered while timing
+    DspBackendType backend = DspBackendType::WamrAot;
+};
+
+/** Timings of one scenario */
+struct Result {
+    Scenario scenario;
+    int blocks = 0;
+    double nsPerSample = 0.0;
+    double realtimeFactor = 0.0;  // audio time / processing time (> 1 keeps up)
+    double p50Us = 0.0;           // per-block latency
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double budgetUs = 0.0;        // duration of one block at the sample rate
+    bool ok = false;
+};
+
+std::vector<uint8_t> loadAOTFile(const std::string& path);
+
+/**
+ * Render a scenario after one second of warm-up and time every block
+ *
+ * The slot contents and the cloud's random seed are fixed, so a scenario
+ * does the same work on every run.
+ */
+Result runScenario(const std::vector<uint8_t>& aot, const Scenario& scenario);
+
+/** Results as a JSON document (one object per scenario) */
+std::string toJson(const std::vector<Result>& results);
+
+} // namespace bench
+} // namespace suna
@@ -0,0 +1,289 @@
+#define CATCH_CONFIG_MAIN
+#include "include/catch_amalgamated.hpp"
+#include "RenderScript.h"
+#include "WavFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Golden-output tests: fixed scenarios (fixed slot content, scripted
+// parameters, the DSP's seeded LCG) rendered through WasmDSP::processBlock
+// and compared with reference renders in tests/cpp/golden/. A scenario is
+// either bit-exact or bounded by a max abs error and a minimum SNR.
+//
+// A missing reference fails its scenario and leaves <name>.actual.wav in
+// the working directory. Record references with SUNA_GOLDEN_UPDATE=1, only
+// for changes that are meant to alter the output.
+
+#ifndef SUNA_GOLDEN_DIR
+#define SUNA_GOLDEN_DIR "golden"
+#endif
+
+namespace {
+
+struct GoldenScenario {
+    const char* name;
+    const char* script;
+    int slots;
+    int blockSize;
+    float maxAbsError;   // 0 = bit-exact
+    double minSnrDb;     // ignored when bit-exact
+};
+
+std::vector<uint8_t> loadAOTFile(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+    auto size = file.tellg();
+    file.seekg(0);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+/** Fixed slot content: a few partials per slot, no randomness */
+std::vector<float> goldenSlot(int slot) {
+    std::vector<float> sample(96000);
+    constexpr double twoPi = 6.283185307179586;
+    const double base = 110.0 * (slot + 2);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        const double t = static_cast<double>(i) / 48000.0;
+        sample[i] = static_cast<float>(0.4 * std::sin(twoPi * base * t) +
+                                       0.2 * std::sin(twoPi * base * 2.01 * t) +
+                                       0.1 * std::sin(twoPi * base * 3.5 * t));
+    }
+    return sample;
+}
+
+std::vector<std::vector<float>> render(const GoldenScenario& scenario) {
+    const auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(!aot.empty());
+
+    suna::RenderScript script;
+    std::string error;
+    const bool parsed = suna::RenderScript::parse(scenario.script, 48000.0, script, error);
+    INFO(error);
+    REQUIRE(parsed);
+
+    suna::RenderOptions options;
+    options.blockSize = scenario.blockSize;
+    for (int slot = 0; slot < scenario.slots; ++slot) {
+        options.slots[slot] = goldenSlot(slot);
+    }
+    suna::RenderResult result;
+    const bool rendered = suna::renderScript(aot, script, options, result);
+    INFO(result.error);
+    REQUIRE(rendered);
+    return { std::move(result.left), std::move(result.right) };
+}
+
+void writeRender(const std::string& path, const std::vector<std::vector<float>>& channels) {
+    suna::WavFile wav;
+    wav.sampleRate = 48000.0;
+    wav.channels = channels;
+    std::string error;
+    if (!wav.write(path, error)) {
+        WARN(error);
+    }
+}
+
+/** Where and how far a render departs from its reference */
+struct Comparison {
+    bool sameLength = true;
+    long firstDivergence = -1;     // sample index, -1 = none beyond the tolerance
+    int divergenceChannel = 0;
+    float expected = 0.0f;
+    float actual = 0.0f;
+    float maxAbsError = 0.0f;
+    double snrDb = INFINITY;
+};
+
+Comparison compare(const std::vector<std::vector<float>>& reference,
+                   const std::vector<std::vector<float>>& rendered, float tolerance) {
+    Comparison result;
+    if (reference.size() != rendered.size()) {
+        result.sameLength = false;
+        return result;
+    }
+    double signal = 0.0, noise = 0.0;
+    for (size_t ch = 0; ch < reference.size(); ++ch) {
+        if (reference[ch].size() != rendered[ch].size()) {
+            result.sameLength = false;
+            return result;
+        }
+        for (size_t i = 0; i < reference[ch].size(); ++i) {
+            const float expected = reference[ch][i];
+            const float actual = rendered[ch][i];
+            const float error = std::abs(actual - expected);
+            signal += static_cast<double>(expected) * expected;
+            noise += static_cast<double>(error) * error;
+            result.maxAbsError = std::max(result.maxAbsError, error);
+            // Bit-exact compares the bits, so NaNs and signed zeros count too
+            const bool diverges = tolerance == 0.0f
+                ? std::memcmp(&expected, &actual, sizeof(float)) != 0
+                : !(error <= tolerance);
+            if (diverges && (result.firstDivergence < 0 ||
+                             static_cast<long>(i) < result.firstDivergence)) {
+                result.firstDivergence = static_cast<long>(i);
+                result.divergenceChannel = static_cast<int>(ch);
+                result.expected = expected;
+                result.actual = actual;
+            }
+        }
+    }
+    if (noise > 0.0) {
+        result.snrDb = 10.0 * std::log10(signal / noise);
+    }
+    return result;
+}
+
+void checkGolden(const GoldenScenario& scenario) {
+    const auto rendered = render(scenario);
+    const std::string referencePath = std::string(SUNA_GOLDEN_DIR) + "/" + scenario.name + ".wav";
+    const std::string actualPath = std::string(scenario.name) + ".actual.wav";
+
+    const char* update = std::getenv("SUNA_GOLDEN_UPDATE");
+    if (update && std::string(update) == "1") {
+        writeRender(referencePath, rendered);
+        SUCCEED("reference written to " << referencePath);
+        return;
+    }
+
+    suna::WavFile reference;
+    std::string error;
+    if (!suna::WavFile::read(referencePath, reference, error)) {
+        writeRender(actualPath, rendered);
+        FAIL("no reference " << referencePath << " (render left in " << actualPath
+             << "; record with SUNA_GOLDEN_UPDATE=1)");
+    }
+
+    const auto result = compare(reference.channels, rendered, scenario.maxAbsError);
+    REQUIRE(result.sameLength);
+    if (result.firstDivergence >= 0 ||
+        (scenario.maxAbsError > 0.0f && result.snrDb < scenario.minSnrDb)) {
+        writeRender(actualPath, rendered);
+    }
+
+    std::ostringstream where;
+    if (result.firstDivergence >= 0) {
+        const long i = result.firstDivergence;
+        where << scenario.name << ": first divergence at sample " << i
+              << " (" << static_cast<double>(i) / 48000.0 << " s, block "
+              << i / scenario.blockSize << ", offset " << i % scenario.blockSize
+              << ", channel " << result.divergenceChannel << "): expected "
+              << result.expected << ", got " << result.actual
+              << "; max abs error " << result.maxAbsError << ", SNR " << result.snrDb
+              << " dB; render left in " << actualPath;
+    }
+    INFO(where.str());
+    CHECK(result.firstDivergence < 0);
+    if (scenario.maxAbsError > 0.0f) {
+        INFO(scenario.name << ": SNR " << result.snrDb << " dB, max abs error " << result.maxAbsError);
+        CHECK(result.snrDb >= scenario.minSnrDb);
+    }
+}
+
+const GoldenScenario CLOUD_UNITY = {
+    "cloud_unity",
+    "0 grain_length 2400\n"
+    "0 density 0.8\n"
+    "0 speed 1.0\n"
+    "0 blend_x 0.3\n"
+    "0.5 blend_y 0.7\n"
+    "1.0 end\n",
+    2, 256, 0.0f, 0.0
+};
+
+const GoldenScenario CLOUD_HERMITE = {
+    "cloud_hermite",
+    "0 interpolation 2\n"
+    "0 grain_length 4224\n"
+    "0 density 1.0\n"
+    "0 speed 0.73\n"
+    "0.3 speed_target 1.4\n"
+    "0.6 blend_x 0.8\n"
+    "1.0 end\n",
+    4, 128, 1e-5f, 100.0
+};
+
+const GoldenScenario CLOUD_SINC = {
+    "cloud_sinc",
+    "0 interpolation 3\n"
+    "0 grain_length 4224\n"
+    "0 density 1.0\n"
+    "0 speed 0.73\n"
+    "0.3 speed_target 1.4\n"
+    "0.6 blend_x 0.8\n"
+    "1.0 end\n",
+    4, 128, 1e-5f, 100.0
+};
+
+const GoldenScenario FROZEN_CLOUD = {
+    "frozen_cloud",
+    "0 grain_length 4800\n"
+    "0 density 0.6\n"
+    "0 speed 0.5\n"
+    "0.25 freeze 1\n"
+    "1.0 freeze 0\n"
+    "1.25 end\n",
+    2, 512, 0.0f, 0.0
+};
+
+const GoldenScenario NOTE_VOICES = {
+    "note_voices",
+    "0 grain_length 1200\n"
+    "0 speed 1.0\n"
+    "1000smp note_on 60 0.8\n"
+    "9000smp note_on 67 0.5\n"
+    "0.5 note_off 60\n"
+    "0.75 all_notes_off\n"
+    "1.0 end\n",
+    1, 64, 0.0f, 0.0
+};
+
+} // namespace
+
+TEST_CASE("Golden: density cloud at unity speed", "[golden]") {
+    checkGolden(CLOUD_UNITY);
+}
+
+TEST_CASE("Golden: Hermite-interpolated cloud with a speed ramp", "[golden]") {
+    checkGolden(CLOUD_HERMITE);
+}
+
+TEST_CASE("Golden: sinc-interpolated cloud with a speed ramp", "[golden]") {
+    checkGolden(CLOUD_SINC);
+}
+
+TEST_CASE("Golden: freeze and release", "[golden]") {
+    checkGolden(FROZEN_CLOUD);
+}
+
+TEST_CASE("Golden: note voices", "[golden]") {
+    checkGolden(NOTE_VOICES);
+}
+
+TEST_CASE("Golden comparison reports the first divergence", "[golden]") {
+    const std::vector<std::vector<float>> reference = { { 0.0f, 0.5f, 0.25f, 1.0f } };
+    auto rendered = reference;
+
+    auto same = compare(reference, rendered, 0.0f);
+    REQUIRE(same.firstDivergence == -1);
+    REQUIRE(same.maxAbsError == 0.0f);
+
+    rendered[0][2] = 0.25f + 1e-7f;
+    rendered[0][3] = 0.9f;
+    auto exact = compare(reference, rendered, 0.0f);
+    REQUIRE(exact.firstDivergence == 2);
+    REQUIRE(exact.actual == rendered[0][2]);
+    auto bounded = compare(reference, rendered, 1e-6f);
+    REQUIRE(bounded.firstDivergence == 3);
+    REQUIRE(bounded.maxAbsError == Catch::Approx(0.1f));
+
+    rendered[0].pop_back();
+    REQUIRE_FALSE(compare(reference, rendered, 0.0f).sameLength);
+}
@@ -0,0 +1,186 @@
+#define CATCH_CONFIG_MAIN
+#include "include/catch_amalgamated.hpp"
+#include "RenderScript.h"
+#include "suna/RtCheck.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Real-time safety: built with SUNA_RT_CHECK, so allocations, blocking
+// locks and file I/O inside WasmDSP::processBlock are intercepted. A
+// scripted session through both backends must not make any.
+
+namespace {
+
+std::vector<uint8_t> loadAOTFile(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+    auto size = file.tellg();
+    file.seekg(0);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+std::vector<float> sessionSlot(int slot) {
+    std::vector<float> sample(48000);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        sample[i] = static_cast<float>(0.5 * std::sin(0.01 * (slot + 1) * static_cast<double>(i)));
+    }
+    return sample;
+}
+
+std::string describeReports() {
+    std::ostringstream out;
+    for (const auto& report : suna::RtCheck::getReports()) {
+        out << report.call << " (" << suna::getRtViolationName(report.kind) << ") x"
+            << report.count << "\n" << report.stack;
+    }
+    return out.str();
+}
+
+// Every host-facing control, note events, a slot cleared while playing and
+// a live input slot
+const char* const SESSION =
+    "0 grain_length 2400\n"
+    "0 density 0.8\n"
+    "0 live_input 3\n"
+    "0 play\n"
+    "0.1 blend_x 0.4\n"
+    "0.1 blend_y -0.3\n"
+    "0.2 interpolation 2\n"
+    "0.2 jitter 0.5\n"
+    "0.25 max_overlap 12\n"
+    "0.3 speed_target 1.5\n"
+    "0.4 note_on 60 0.9\n"
+    "0.45 note_on 64 0.6\n"
+    "0.5 freeze 1\n"
+    "0.6 clear 1\n"
+    "0.7 freeze 0\n"
+    "0.75 note_off 60\n"
+    "0.8 speed -0.5\n"
+    "0.9 all_notes_off\n"
+    "0.95 stop\n"
+    "1.0 end\n";
+
+void checkSession(suna::DspBackendType backend, int renderThreads) {
+    const auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    if (backend == suna::DspBackendType::WamrAot) {
+        REQUIRE(!aot.empty());
+    }
+
+    suna::RenderScript script;
+    std::string error;
+    const bool parsed = suna::RenderScript::parse(SESSION, 48000.0, script, error);
+    INFO(error);
+    REQUIRE(parsed);
+
+    suna::RenderOptions options;
+    options.blockSize = 256;
+    options.backend = backend;
+    options.renderThreads = renderThreads;
+    for (int slot = 0; slot < 3; ++slot) {
+        options.slots[slot] = sessionSlot(slot);
+    }
+    options.inputLeft = sessionSlot(4);
+    options.inputRight = sessionSlot(5);
+
+    suna::RtCheck::reset();
+    suna::RenderResult result;
+    const bool rendered = suna::renderScript(aot, script, options, result);
+    INFO(suna::getBackendName(backend) << ", " << renderThreads << " thread(s): " << result.error);
+    REQUIRE(rendered);
+    REQUIRE(result.droppedBlocks == 0);
+
+    INFO(describeReports());
+    CHECK(suna::RtCheck::getViolationCount() == 0);
+}
+
+} // namespace
+
+TEST_CASE("RtCheck reports violations on realtime threads only", "[rtcheck]") {
+    suna::RtCheck::reset();
+    {
+        suna::RtCheck::Scope realtime;
+        void* memory = ::operator new(64);
+        ::operator delete(memory);
+        {
+            suna::RtCheck::Disabler allowed;
+            ::operator delete(::operator new(64));
+        }
+    }
+    {
+        suna::RtCheck::Scope offline(false);
+        ::operator delete(::operator new(64));
+    }
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Allocation) == 1);
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Deallocation) == 1);
+
+    // Over-aligned allocations take their own operator new
+    {
+        suna::RtCheck::Scope realtime;
+        const std::align_val_t alignment{64};
+        ::operator delete(::operator new(256, alignment), alignment);
+    }
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Allocation) == 2);
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Deallocation) == 2);
+
+#if defined(__GLIBC__)
+    {
+        suna::RtCheck::Scope realtime;
+        // volatile, so the compiler cannot drop an unused allocation
+        void* volatile aligned = std::aligned_alloc(64, 256);
+        std::free(aligned);
+        void* memory = nullptr;
+        if (posix_memalign(&memory, 64, 256) == 0) {
+            aligned = memory;
+            std::free(aligned);
+        }
+    }
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Allocation) == 4);
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Deallocation) == 4);
+#endif
+
+#if defined(__GLIBC__)
+    std::mutex mutex;
+    {
+        suna::RtCheck::Scope realtime;
+        // try_lock never blocks, so only lock() counts
+        if (mutex.try_lock()) mutex.unlock();
+        mutex.lock();
+        mutex.unlock();
+        if (std::FILE* file = std::fopen("/dev/null", "w")) std::fclose(file);
+    }
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::Lock) == 1);
+    REQUIRE(suna::RtCheck::getViolationCount(suna::RtViolation::FileIo) >= 1);
+#endif
+
+    const auto reports = suna::RtCheck::getReports();
+    REQUIRE(!reports.empty());
+    REQUIRE(reports[0].call == "operator new");
+    REQUIRE(reports[0].count == 1);
+    suna::RtCheck::reset();
+    REQUIRE(suna::RtCheck::getViolationCount() == 0);
+}
+
+TEST_CASE("Realtime session is RT-safe: native backend", "[rtcheck]") {
+    checkSession(suna::DspBackendType::Native, 1);
+}
+
+TEST_CASE("Realtime session is RT-safe: native backend, render workers", "[rtcheck]") {
+    checkSession(suna::DspBackendType::Native, 2);
+}
+
+TEST_CASE("Realtime session is RT-safe: WAMR backend", "[rtcheck]") {
+    checkSession(suna::DspBackendType::WamrAot, 1);
+}
+
+TEST_CASE("Realtime session is RT-safe: WAMR backend, render workers", "[rtcheck]") {
+    checkSession(suna::DspBackendType::WamrAot, 2);
+}
@@ -0,0 +1,161 @@
+// wasm_dsp_bench - cost of the grain cloud through WasmDSP::processBlock
+//
+// Sweeps one parameter at a time around a base scenario (density 0.5,
+// 4224-sample grains, 4 slots, unity speed, not frozen, 256-sample blocks)
+// and prints ns/sample, the real-time factor and per-block latency
+// percentiles as JSON. The readers are also timed off unity speed, where
+// they interpolate, and a dense 96 kHz cloud across render threads.
+//
+// --backend both runs every scenario through WAMR and the native engine
+// and prints the WAMR/native time ratio, i.e. the cost of the WASM boundary.
+//
+// Usage: wasm_dsp_bench [--aot PATH] [--seconds S] [--filter TEXT] [--out FILE]
+//                       [--backend wamr|native|both]
+
+#include "dsp_bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using suna::bench::Scenario;
+
+static std::string label(const char* prefix, float value) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%s_%.2f", prefix, value);
+    return text;
+}
+
+static std::vector<Scenario> buildSweep(double seconds) {
+    Scenario base;
+    base.seconds = seconds;
+
+    std::vector<Scenario> sweep;
+    auto add = [&](const std::string& name, auto&& change) {
+        Scenario s = base;
+        change(s);
+        s.name = name;
+        sweep.push_back(s);
+    };
+
+    add("base", [](Scenario&) {});
+    for (float density : { 0.0f, 0.25f, 0.75f, 1.0f }) {
+        add(label("density", density),
+            [density](Scenario& s) { s.density = density; });
+    }
+    for (int length : { 256, 1024, 16384, 48000 }) {
+        add("grain_length_" + std::to_string(length),
+            [length](Scenario& s) { s.grainLength = length; });
+    }
+    for (int slots : { 1, 2, 8 }) {
+        add("slots_" + std::to_string(slots), [slots](Scenario& s) { s.slots = slots; });
+    }
+    for (float speed : { 0.5f, 0.73f, 2.0f, -1.0f }) {
+        add(label("speed", speed),
+            [speed](Scenario& s) { s.speed = speed; });
+    }
+    for (int mode : { 0, 1, 3 }) {
+        add("interpolation_" + std::to_string(mode),
+            [mode](Scenario& s) { s.interpolation = mode; });
+    }
+    // Unity speed skips the linear and Hermite readers; 0.73 exercises all
+    for (int mode : { 0, 1, 2, 3 }) {
+        add("interpolation_" + std::to_string(mode) + "_speed_0.73", [mode](Scenario& s) {
+            s.interpolation = mode;
+            s.speed = 0.73f;
+        });
+    }
+    add("freeze", [](Scenario& s) { s.freeze = true; });
+    for (int block = 32; block <= 4096; block *= 2) {
+        if (block == base.blockSize) continue;
+        add("block_" + std::to_string(block), [block](Scenario& s) { s.blockSize = block; });
+    }
+    // 500 grains at 96 kHz in 512-sample blocks, split across the render threads
+    for (int threads : { 1, 2, 4, 8 }) {
+        add("dense_96k_threads_" + std::to_string(threads), [threads](Scenario& s) {
+            s.density = 1.0f;
+            s.speed = 0.73f;
+            s.sampleRate = 96000.0;
+            s.grainPoolSize = 1000;
+            s.maxOverlap = 500;
+            s.blockSize = 512;
+            s.renderThreads = threads;
+        });
+    }
+    return sweep;
+}
+
+int main(int argc, char** argv) {
+    std::string aotPath = "../../../plugin/resources/suna_dsp.aot";
+    std::string filter;
+    std::string outPath;
+    double seconds = 5.0;
+    std::vector<suna::DspBackendType> backends = { suna::DspBackendType::WamrAot };
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--aot") == 0 && hasValue) {
+            aotPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--backend") == 0 && hasValue &&
+                   std::strcmp(argv[i + 1], "both") == 0) {
+            ++i;
+            backends = { suna::DspBackendType::WamrAot, suna::DspBackendType::Native };
+        } else if (std::strcmp(argv[i], "--backend") == 0 && hasValue &&
+                   suna::parseBackendName(argv[i + 1], backends[0])) {
+            ++i;
+            backends.resize(1);
+        } else {
+            std::fprintf(stderr,
+                "usage: %s [--aot PATH] [--seconds S] [--filter TEXT] [--out FILE]\n"
+                "          [--backend wamr|native|both]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const bool needsAot = backends[0] == suna::DspBackendType::WamrAot;
+    const auto aot = needsAot ? suna::bench::loadAOTFile(aotPath) : std::vector<uint8_t>();
+    if (needsAot && aot.empty()) {
+        std::fprintf(stderr, "wasm_dsp_bench: cannot read %s\n", aotPath.c_str());
+        return 1;
+    }
+
+    std::vector<suna::bench::Result> results;
+    for (auto scenario : buildSweep(seconds > 0.0 ? seconds : 5.0)) {
+        if (!filter.empty() && scenario.name.find(filter) == std::string::npos) continue;
+        for (size_t b = 0; b < backends.size(); ++b) {
+            scenario.backend = backends[b];
+            std::fprintf(stderr, "%-20s %-6s ", scenario.name.c_str(),
+                         suna::getBackendName(scenario.backend));
+            auto result = suna::bench::runScenario(aot, scenario);
+            std::fprintf(stderr, "%8.2f ns/sample  %7.1fx real time  p99 %8.1f us",
+                         result.nsPerSample, result.realtimeFactor, result.p99Us);
+            if (b > 0 && result.nsPerSample > 0.0) {
+                // Paired with the WAMR run just before it
+                std::fprintf(stderr, "  wamr/native %.2fx",
+                             results.back().nsPerSample / result.nsPerSample);
+            }
+            std::fputc('\n', stderr);
+            results.push_back(result);
+        }
+    }
+
+    const auto json = suna::bench::toJson(results);
+    if (outPath.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else {
+        std::ofstream(outPath) << json;
+    }
+
+    for (const auto& result : results) {
+        if (!result.ok) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,270 @@
+// wasm_dsp_perf_test - performance regression gate (ctest: wasm_dsp_perf_test)
+//
+// Times fixed, deterministic grain scenarios through WasmDSP::processBlock
+// and gates them two ways:
+// - Structural checks, which hold on any machine. The cloud's cost must
+//   grow no faster than its grain count. The frozen cloud must not cost
+//   more than the same cloud playing. The WAMR module must stay within
+//   max_wamr_native_ratio of the native engine.
+// - Per-scenario ns/sample against perf_baseline.json. A scenario slower
+//   than its baseline by more than the tolerance fails. Scenarios without
+//   a recorded baseline are only reported.
+//
+// Baselines are machine specific: record them on the machine that runs the
+// gate with --update, and commit the file.
+//
+// Usage: wasm_dsp_perf_test --baseline FILE [--aot PATH] [--tolerance T] [--update]
+// SUNA_PERF_TOLERANCE overrides the file's tolerance (e.g. 0.5 on noisy CI).
+
+#include "dsp_bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using suna::bench::Scenario;
+
+static constexpr int RUNS_PER_SCENARIO = 3;
+
+static std::vector<Scenario> gateScenarios() {
+    std::vector<Scenario> scenarios;
+    auto add = [&](const char* name, float density, int slots, float speed, int interpolation,
+                   bool freeze, int block) {
+        Scenario s;
+        s.name = name;
+        s.density = density;
+        s.slots = slots;
+        s.speed = speed;
+        s.interpolation = interpolation;
+        s.freeze = freeze;
+        s.blockSize = block;
+        s.seconds = 2.0;
+        scenarios.push_back(s);
+    };
+    add("dense_8_slots_block_128", 1.0f, 8, 1.0f, 2, false, 128);
+    add("quarter_8_slots_block_128", 0.25f, 8, 1.0f, 2, false, 128);
+    add("dense_8_slots_hermite", 1.0f, 8, 0.73f, 2, false, 128);
+    add("dense_8_slots_sinc", 1.0f, 8, 0.73f, 3, false, 128);
+    add("frozen_8_slots_block_128", 1.0f, 8, 0.73f, 2, true, 128);
+    add("sparse_1_slot_block_32", 0.25f, 1, 1.0f, 2, false, 32);
+    return scenarios;
+}
+
+// Rendered on the native engine too, for the WAMR/native ratio
+static const char* const RATIO_SCENARIO = "dense_8_slots_hermite";
+
+struct Baseline {
+    double tolerance = 0.25;
+    double maxWamrNativeRatio = 4.0;
+    std::map<std::string, double> nsPerSample;  // scenarios recorded so far
+};
+
+// Best of a few runs: scheduling noise only ever adds time
+static bool runBest(const std::vector<uint8_t>& aot, const Scenario& scenario,
+                    suna::bench::Result& best) {
+    for (int run = 0; run < RUNS_PER_SCENARIO; ++run) {
+        auto result = suna::bench::runScenario(aot, scenario);
+        if (!result.ok) {
+            std::fprintf(stderr, "wasm_dsp_perf_test: %s (%s) failed to run\n",
+                         scenario.name.c_str(), suna::getBackendName(scenario.backend));
+            return false;
+        }
+        if (run == 0 || result.nsPerSample < best.nsPerSample) best = result;
+    }
+    return true;
+}
+
+static double nsPerSample(const std::vector<suna::bench::Result>& results, const char* name) {
+    for (const auto& result : results) {
+        if (result.scenario.name == name) return result.nsPerSample;
+    }
+    return 0.0;
+}
+
+/** Prints one line per check; returns the number that failed */
+static int checkStructure(const std::vector<suna::bench::Result>& results, double nativeNs,
+                          double tolerance, double maxWamrNativeRatio) {
+    struct Check {
+        const char* name;
+        double ratio;
+        double limit;
+    };
+    // A quarter of the density is a quarter of the grains (min_grain_count 0)
+    const Check checks[] = {
+        { "dense / quarter density", nsPerSample(results, "dense_8_slots_block_128") /
+              nsPerSample(results, "quarter_8_slots_block_128"), 4.0 * (1.0 + tolerance) },
+        { "frozen / playing", nsPerSample(results, "frozen_8_slots_block_128") /
+              nsPerSample(results, RATIO_SCENARIO), 1.0 + tolerance },
+        { "wamr / native", nsPerSample(results, RATIO_SCENARIO) / nativeNs, maxWamrNativeRatio },
+    };
+    std::printf("%-28s %14s %14s\n", "check", "ratio", "limit");
+    int failed = 0;
+    for (const auto& check : checks) {
+        const bool ok = check.ratio <= check.limit;
+        if (!ok) ++failed;
+        std::printf("%-28s %14.2f %14.2f  %s\n", check.name, check.ratio, check.limit,
+                    ok ? "ok" : "FAILED");
+    }
+    return failed;
+}
+
+// Reads the file written by writeBaseline: a tolerance and one
+// "name": ns_per_sample (or null) pair per scenario
+static bool readBaseline(const std::string& path, Baseline& baseline) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    size_t pos = 0;
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        const size_t end = text.find('"', pos + 1);
+        if (end == std::string::npos) break;
+        const std::string key = text.substr(pos + 1, end - pos - 1);
+        size_t value = text.find(':', end);
+        pos = end + 1;
+        if (value == std::string::npos || key == "scenarios") continue;
+        value = text.find_first_not_of(" \t\r\n", value + 1);
+        if (value == std::string::npos || text.compare(value, 4, "null") == 0) continue;
+        char* parsed = nullptr;
+        const double number = std::strtod(text.c_str() + value, &parsed);
+        if (parsed == text.c_str() + value) continue;
+        if (key == "tolerance") {
+            baseline.tolerance = number;
+        } else if (key == "max_wamr_native_ratio") {
+            baseline.maxWamrNativeRatio = number;
+        } else {
+            baseline.nsPerSample[key] = number;
+        }
+    }
+    return true;
+}
+
+static bool writeBaseline(const std::string& path, const Baseline& baseline,
+                          const std::vector<suna::bench::Result>& results) {
+    std::ofstream file(path);
+    if (!file) return false;
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "{\n  \"tolerance\": %.2f,\n  \"max_wamr_native_ratio\": %.2f,\n"
+                  "  \"scenarios\": {\n", baseline.tolerance, baseline.maxWamrNativeRatio);
+    file << line;
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::snprintf(line, sizeof(line), "    \"%s\": %.3f%s\n",
+                      results[i].scenario.name.c_str(), results[i].nsPerSample,
+                      i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "  }\n}\n";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string aotPath = "../../../plugin/resources/suna_dsp.aot";
+    std::string baselinePath;
+    double toleranceOverride = -1.0;
+    bool update = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--aot") == 0 && hasValue) {
+            aotPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            toleranceOverride = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else {
+            baselinePath.clear();
+            break;
+        }
+    }
+    if (baselinePath.empty()) {
+        std::fprintf(stderr,
+            "usage: %s --baseline FILE [--aot PATH] [--tolerance T] [--update]\n", argv[0]);
+        return 2;
+    }
+    if (const char* env = std::getenv("SUNA_PERF_TOLERANCE")) {
+        if (toleranceOverride < 0.0) toleranceOverride = std::atof(env);
+    }
+
+    const auto aot = suna::bench::loadAOTFile(aotPath);
+    if (aot.empty()) {
+        std::fprintf(stderr, "wasm_dsp_perf_test: cannot read %s\n", aotPath.c_str());
+        return 1;
+    }
+
+    Baseline baseline;
+    if (!readBaseline(baselinePath, baseline) && !update) {
+        std::fprintf(stderr, "wasm_dsp_perf_test: cannot read %s\n", baselinePath.c_str());
+        return 1;
+    }
+    const double tolerance = toleranceOverride >= 0.0 ? toleranceOverride : baseline.tolerance;
+
+    std::vector<suna::bench::Result> results;
+    suna::bench::Result native;
+    for (const auto& scenario : gateScenarios()) {
+        suna::bench::Result best;
+        if (!runBest(aot, scenario, best)) return 1;
+        results.push_back(best);
+        if (scenario.name == RATIO_SCENARIO) {
+            Scenario nativeScenario = scenario;
+            nativeScenario.backend = suna::DspBackendType::Native;
+            if (!runBest(aot, nativeScenario, native)) return 1;
+        }
+    }
+
+    if (update) {
+        if (!writeBaseline(baselinePath, baseline, results)) {
+            std::fprintf(stderr, "wasm_dsp_perf_test: cannot write %s\n", baselinePath.c_str());
+            return 1;
+        }
+        std::printf("Baseline written to %s\n", baselinePath.c_str());
+        return 0;
+    }
+
+    std::printf("%-28s %14s %14s %9s\n", "scenario", "baseline", "measured", "change");
+    int slower = 0;
+    int missing = 0;
+    for (const auto& result : results) {
+        const auto& name = result.scenario.name;
+        const auto it = baseline.nsPerSample.find(name);
+        if (it == baseline.nsPerSample.end() || it->second <= 0.0) {
+            std::printf("%-28s %14s %11.2f ns %9s  not recorded\n",
+                        name.c_str(), "-", result.nsPerSample, "-");
+            ++missing;
+            continue;
+        }
+        const double change = result.nsPerSample / it->second - 1.0;
+        const char* verdict = "ok";
+        if (change > tolerance) {
+            verdict = "SLOWER";
+            ++slower;
+        } else if (change < -tolerance) {
+            verdict = "faster (update the baseline?)";
+        }
+        std::printf("%-28s %11.2f ns %11.2f ns %+8.1f%%  %s\n",
+                    name.c_str(), it->second, result.nsPerSample, change * 100.0, verdict);
+    }
+    std::printf("tolerance: %.0f%%\n\n", tolerance * 100.0);
+
+    const int broken = checkStructure(results, native.nsPerSample, tolerance,
+                                      baseline.maxWamrNativeRatio);
+    if (missing > 0) {
+        std::printf("%d scenario(s) have no baseline; record one with --update\n", missing);
+    }
+    if (slower > 0) {
+        std::printf("FAILED: %d scenario(s) slower than the baseline beyond the tolerance\n", slower);
+    }
+    if (broken > 0) {
+        std::printf("FAILED: %d structural check(s) over their limit\n", broken);
+    }
+    return slower > 0 || broken > 0 ? 1 : 0;
+}
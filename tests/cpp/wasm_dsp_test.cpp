@@ -1,9 +1,17 @@
 #define CATCH_CONFIG_MAIN
 #include "include/catch_amalgamated.hpp"
 #include "suna/WasmDSP.h"
+#include "suna/SampleStore.h"
+#include "suna/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <sstream>
 #include <fstream>
 #include <vector>
 #include <cmath>
+#include <string>
+#include <thread>
 
 static std::vector<uint8_t> loadAOTFile(const char* path) {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
@@ -128,3 +136,749 @@ TEST_CASE("WasmDSP multiple blocks", "[wasmdsp]") {
         }
     }
 }
+
+TEST_CASE("WasmDSP control path does not allocate", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 512);
+
+    std::vector<float> sample(4800);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        sample[i] = std::sin(2.0f * 3.14159f * 220.0f * static_cast<float>(i) / 48000.0f);
+    }
+    for (int slot = 0; slot < 4; ++slot) {
+        dsp.loadSample(slot, sample.data(), static_cast<int>(sample.size()));
+    }
+
+    constexpr int numSamples = 512;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+
+    // Counted by the module at every allocation, freed blocks reused or not
+    const int64_t before = dsp.getAllocationCount();
+    REQUIRE(before > 0);
+
+    for (int block = 0; block < 50; ++block) {
+        const float t = static_cast<float>(block) / 50.0f;
+        dsp.setBlendX(std::sin(6.28f * t));
+        dsp.setBlendY(std::cos(6.28f * t));
+        dsp.setGrainDensity(t);
+        dsp.setGrainLength(1000 + block * 20);
+        dsp.setSpeedTarget(0.5f + t);
+        dsp.setGrainJitter(t * 0.5f);
+        dsp.setMaxOverlap(20 + block);
+        dsp.setInterpolation(block % 4);
+        dsp.setFreeze(block >= 25 && block < 40 ? 1 : 0);
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    }
+
+    REQUIRE(dsp.getAllocationCount() == before);
+}
+
+TEST_CASE("WasmDSP reads grains nearest by default", "[wasmdsp]") {
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    std::vector<float> sample(48000);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        sample[i] = std::sin(2.0f * 3.14159f * 220.0f * static_cast<float>(i) / 48000.0f);
+    }
+
+    // Same calls, only the reader differs (-1 = left at the default)
+    auto render = [&](int mode) {
+        suna::WasmDSP dsp;
+        REQUIRE(dsp.initialize(aot.data(), aot.size()));
+        dsp.prepareToPlay(48000.0, 256);
+        dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+        if (mode >= 0) dsp.setInterpolation(mode);
+        dsp.setGrainDensity(1.0f);
+        dsp.setPlaybackSpeed(0.73f);
+        std::vector<float> in(256, 0.0f), leftOut(256), rightOut(256), rendered;
+        for (int block = 0; block < 20; ++block) {
+            dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 256);
+            rendered.insert(rendered.end(), leftOut.begin(), leftOut.end());
+        }
+        return rendered;
+    };
+
+    const auto byDefault = render(-1);
+    REQUIRE(byDefault == render(0));
+    REQUIRE(byDefault != render(2));
+}
+
+TEST_CASE("WasmDSP modulation buffers", "[wasmdsp]") {
+    // Both instances get the same calls; lanes driven on `modulated` are
+    // checked sample for sample against the setters driving `reference`
+    suna::WasmDSP reference;
+    suna::WasmDSP modulated;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(reference.initialize(aot.data(), aot.size()));
+    REQUIRE(modulated.initialize(aot.data(), aot.size()));
+    REQUIRE(modulated.getModulationBuffer(suna::ModulationLane::BlendX) == nullptr);
+
+    std::vector<float> sample(4800);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        sample[i] = std::sin(2.0f * 3.14159f * 220.0f * static_cast<float>(i) / 48000.0f);
+    }
+    for (suna::WasmDSP* dsp : { &reference, &modulated }) {
+        dsp->prepareToPlay(48000.0, 256);
+        dsp->loadSample(0, sample.data(), static_cast<int>(sample.size()));
+        dsp->loadSample(1, sample.data(), static_cast<int>(sample.size()));
+        dsp->setGrainLength(1000);
+        dsp->setBlendX(0.3f);
+        dsp->setPlaybackSpeed(0.75f);
+        dsp->setGrainDensity(0.0f);
+    }
+
+    float* blendX = modulated.getModulationBuffer(suna::ModulationLane::BlendX);
+    float* blendY = modulated.getModulationBuffer(suna::ModulationLane::BlendY);
+    float* speed = modulated.getModulationBuffer(suna::ModulationLane::Speed);
+    REQUIRE(blendX != nullptr);
+    REQUIRE(blendY == blendX + 256);
+    REQUIRE(speed == blendY + 256);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f), right(numSamples);
+    std::vector<float> referenceOut(numSamples), modulatedOut(numSamples);
+    int block = 0;
+    // Renders both; returns the largest difference between them
+    auto render = [&](int numBlocks, auto&& fillLanes) {
+        float difference = 0.0f;
+        for (int end = block + numBlocks; block < end; ++block) {
+            fillLanes();
+            reference.processBlock(in.data(), in.data(), referenceOut.data(), right.data(), numSamples);
+            modulated.processBlock(in.data(), in.data(), modulatedOut.data(), right.data(), numSamples);
+            for (int i = 0; i < numSamples; ++i) {
+                REQUIRE(std::isfinite(modulatedOut[i]));
+                difference = std::max(difference, std::abs(modulatedOut[i] - referenceOut[i]));
+            }
+        }
+        return difference;
+    };
+    auto setterValues = [&] {
+        std::fill(blendX, blendX + numSamples, 0.3f);
+        std::fill(speed, speed + numSamples, 0.75f);
+    };
+    // 5 Hz LFO on blend X, speed swept from 1.0 to 1.5 (grains never
+    // outlive the reference's, so both start the same grains)
+    auto sweep = [&] {
+        for (int i = 0; i < numSamples; ++i) {
+            const float t = static_cast<float>(block * numSamples + i) / 48000.0f;
+            blendX[i] = std::sin(2.0f * 3.14159f * 5.0f * t);
+            speed[i] = 1.0f + std::fmod(t, 0.05f) * 10.0f;
+        }
+    };
+    auto setDensity = [&](float density) {
+        reference.setGrainDensity(density);
+        modulated.setGrainDensity(density);
+    };
+
+    // Gains settle on the blend position before the lanes take over
+    REQUIRE(render(20, [] {}) == 0.0f);
+
+    // A speed lane holding the setter value plays exactly like the setter
+    modulated.setModulationEnabled(suna::ModulationLane::Speed, true);
+    setDensity(0.5f);
+    REQUIRE(render(20, setterValues) == 0.0f);
+    REQUIRE(modulatedOut[numSamples - 1] != 0.0f);
+
+    // So does a blend lane, but for the last bits of the gains: lanes ramp
+    // onto them, the setter's one-pole smoothing stops within an ulp
+    modulated.setModulationEnabled(suna::ModulationLane::BlendX, true);
+    REQUIRE(render(20, setterValues) < 1e-6f);
+
+    // Moving lanes change the cloud
+    REQUIRE(render(20, sweep) > 0.01f);
+
+    // Silence, then disable the lanes away from the setter values: the
+    // setter blend and speed come back
+    setDensity(0.0f);
+    render(20, sweep);
+    REQUIRE(referenceOut[numSamples - 1] == 0.0f);
+    REQUIRE(modulatedOut[numSamples - 1] == 0.0f);
+    modulated.setModulationEnabled(suna::ModulationLane::BlendX, false);
+    modulated.setModulationEnabled(suna::ModulationLane::Speed, false);
+    REQUIRE(render(20, [] {}) == 0.0f);
+    setDensity(0.5f);
+    REQUIRE(render(20, [] {}) < 1e-6f);
+    REQUIRE(modulatedOut[numSamples - 1] != 0.0f);
+}
+
+TEST_CASE("WasmDSP events land on their sample offset", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+
+    // Constant signal, so any started grain is audible after its first sample
+    std::vector<float> sample(48000, 0.5f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.setPlaybackSpeed(1.0f);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+
+    // No grains at density 0
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+
+    // Density rises at sample 100: the first grain starts exactly there
+    // (its envelope is 0 on its first sample)
+    REQUIRE(dsp.queueEvent(100, suna::EventType::GrainDensity, 1.0f));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    for (int i = 0; i <= 100; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+    REQUIRE(leftOut[101] != 0.0f);
+
+    // Posted events apply at the start of the next block. A newer value of
+    // a type replaces one not applied yet, so posting never runs out of room
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(dsp.postEvent(suna::EventType::GrainDensity, 1.0f));
+    }
+    REQUIRE(dsp.postEvent(suna::EventType::GrainDensity, 0.0f));
+    REQUIRE_FALSE(dsp.postEvent(suna::EventType::StopAll, 0.0f));
+    // Density 0 won: the grains playing end and none follow
+    bool silent = false;
+    for (int block = 0; block < 200 && !silent; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+        silent = std::all_of(leftOut.begin(), leftOut.end(), [](float s) { return s == 0.0f; });
+    }
+    REQUIRE(silent);
+}
+
+TEST_CASE("WasmDSP note events play grains while held", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+
+    std::vector<float> sample(48000, 0.5f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.setPlaybackSpeed(1.0f);
+    dsp.setGrainLength(1000);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+
+    // Density stays 0, so only the note's grains sound, from its offset on
+    REQUIRE(dsp.queueEvent(50, suna::EventType::NoteOn, 1.0f, 72));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    for (int i = 0; i <= 50; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+    REQUIRE(leftOut[51] != 0.0f);
+
+    // After note off the grains play out and the output decays to silence
+    REQUIRE(dsp.queueEvent(0, suna::EventType::NoteOff, 0.0f, 72));
+    for (int block = 0; block < 8; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    }
+    for (int i = 0; i < numSamples; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+}
+
+TEST_CASE("WasmDSP splits blocks larger than prepared", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+
+    std::vector<float> sample(48000, 0.5f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.setPlaybackSpeed(1.0f);
+    dsp.setGrainLength(100);
+
+    constexpr int numSamples = 1024;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+
+    // The event sits in the third chunk and keeps its host-block offset
+    REQUIRE(dsp.queueEvent(600, suna::EventType::GrainDensity, 1.0f));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    for (int i = 0; i <= 600; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+    REQUIRE(leftOut[601] != 0.0f);
+    REQUIRE(leftOut[numSamples - 1] != 0.0f);
+
+    // Fixed quantum: same offsets, smaller chunks (the short grains of the
+    // previous block have ended before the next one)
+    dsp.setProcessingQuantum(64);
+    REQUIRE(dsp.queueEvent(0, suna::EventType::GrainDensity, 0.0f));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    REQUIRE(dsp.queueEvent(130, suna::EventType::GrainDensity, 1.0f));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 200);
+    for (int i = 0; i <= 130; ++i) {
+        REQUIRE(leftOut[i] == 0.0f);
+    }
+    REQUIRE(leftOut[131] != 0.0f);
+}
+
+TEST_CASE("WasmDSP keeps the I/O buffers below the sample slots", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    constexpr int numSamples = 2 * suna::WasmDSP::MAX_IO_BLOCK_SIZE;
+    dsp.prepareToPlay(48000.0, numSamples);
+
+    std::vector<float> sample(48000, 0.5f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.setPlaybackSpeed(1.0f);
+    dsp.setGrainDensity(1.0f);
+
+    // The prepared size was clamped, so the block renders in two chunks
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    REQUIRE(dsp.getStats().splitBlocks == 1);
+    REQUIRE(leftOut[numSamples - 1] != 0.0f);
+}
+
+TEST_CASE("WasmDSP non-realtime mode renders long blocks", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.setNonRealtime(true);
+    dsp.prepareToPlay(48000.0, 256);
+
+    std::vector<float> sample(48000, 0.5f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.setPlaybackSpeed(1.0f);
+    dsp.setGrainDensity(1.0f);
+
+    // Twice the offline I/O region: two chunks, both rendered
+    constexpr int numSamples = 2 * suna::WasmDSP::NON_REALTIME_BLOCK_SIZE;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    REQUIRE(leftOut[suna::WasmDSP::NON_REALTIME_BLOCK_SIZE + 1] != 0.0f);
+    REQUIRE(leftOut[numSamples - 1] != 0.0f);
+    REQUIRE(dsp.isNonRealtime());
+
+    // A host block beyond the I/O region is capped there, not allocated
+    // over the sample slots (preparing again empties the slots)
+    constexpr int hostBlock = 3 * suna::WasmDSP::MAX_IO_BLOCK_SIZE;
+    dsp.prepareToPlay(48000.0, hostBlock);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    std::vector<float> longIn(hostBlock, 0.0f);
+    std::vector<float> longLeft(hostBlock), longRight(hostBlock);
+    const uint64_t splitBefore = dsp.getStats().splitBlocks;
+    dsp.processBlock(longIn.data(), longIn.data(), longLeft.data(), longRight.data(), hostBlock);
+    REQUIRE(dsp.getStats().splitBlocks == splitBefore + 1);
+    REQUIRE(longLeft[hostBlock - 1] != 0.0f);
+}
+
+// Renders a dense cloud and returns the left output of every block
+static std::vector<float> renderCloud(int renderThreads, int numBlocks, int quantum = 0) {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size(), renderThreads));
+    REQUIRE(dsp.getRenderThreadCount() == renderThreads);
+    dsp.prepareToPlay(48000.0, 256);
+    dsp.setProcessingQuantum(quantum);
+
+    std::vector<float> sample(48000);
+    for (size_t i = 0; i < sample.size(); ++i) {
+        sample[i] = std::sin(2.0f * 3.14159f * 220.0f * static_cast<float>(i) / 48000.0f);
+    }
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    dsp.loadSample(1, sample.data(), static_cast<int>(sample.size()));
+    dsp.setGrainDensity(1.0f);
+    dsp.setPlaybackSpeed(0.73f);
+    dsp.setBlendX(0.3f);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+    std::vector<float> rendered;
+    for (int block = 0; block < numBlocks; ++block) {
+        if (block == numBlocks / 2) {
+            REQUIRE(dsp.queueEvent(100, suna::EventType::PlaybackSpeed, 1.2f));
+        }
+        // Ramps through zero speed, then frozen grains loop back
+        if (block == numBlocks * 3 / 4) {
+            REQUIRE(dsp.queueEvent(0, suna::EventType::PlaybackSpeed, -0.6f));
+        }
+        if (block == numBlocks * 7 / 8) {
+            REQUIRE(dsp.queueEvent(0, suna::EventType::Freeze, 1.0f));
+        }
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+        rendered.insert(rendered.end(), leftOut.begin(), leftOut.end());
+    }
+    return rendered;
+}
+
+TEST_CASE("WasmDSP render workers sum to the single-thread output", "[wasmdsp]") {
+    const auto single = renderCloud(1, 40);
+    const auto split = renderCloud(2, 40);
+    REQUIRE(single.size() == split.size());
+    // Same grains, only the order of the final sums differs
+    for (size_t i = 0; i < single.size(); ++i) {
+        REQUIRE(std::abs(single[i] - split[i]) < 1e-5f);
+    }
+}
+
+TEST_CASE("WasmDSP renders small chunks on the audio thread", "[wasmdsp]") {
+    // A quantum below MIN_PARALLEL_BLOCK_SIZE renders every share on the
+    // audio thread; the workers stay and the clouds stay in step
+    const int quantum = suna::WasmDSP::MIN_PARALLEL_BLOCK_SIZE / 2;
+    const auto single = renderCloud(1, 40, quantum);
+    const auto split = renderCloud(4, 40, quantum);
+    REQUIRE(single.size() == split.size());
+    for (size_t i = 0; i < single.size(); ++i) {
+        REQUIRE(std::abs(single[i] - split[i]) < 1e-5f);
+    }
+
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size(), 4));
+    dsp.prepareToPlay(48000.0, quantum);
+    REQUIRE(dsp.getRenderThreadCount() == 4);
+    dsp.prepareToPlay(48000.0, 256);
+    REQUIRE(dsp.getRenderThreadCount() == 4);
+}
+
+#if SUNA_SHARED_SAMPLES
+TEST_CASE("WasmDSP slots with equal content share one stored sample", "[wasmdsp]") {
+    auto& store = suna::SampleStore::instance();
+    {
+        suna::WasmDSP dsp;
+        auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+        REQUIRE(dsp.initialize(aot.data(), aot.size()));
+        dsp.prepareToPlay(48000.0, 256);
+
+        std::vector<float> sample(48000, 0.5f);
+        dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+        dsp.loadSample(1, sample.data(), static_cast<int>(sample.size()));
+        REQUIRE(store.getSampleCount() == 1);
+        REQUIRE(store.getBytesInUse() == sample.size() * sizeof(float));
+
+        // Grains read the shared copy
+        dsp.setGrainDensity(1.0f);
+        std::vector<float> in(256, 0.0f), leftOut(256), rightOut(256);
+        for (int i = 0; i < 4; ++i) {
+            dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 256);
+        }
+        REQUIRE(leftOut[255] != 0.0f);
+
+        dsp.clearSlot(0);
+        REQUIRE(store.getSampleCount() == 1);
+        dsp.clearSlot(1);
+        REQUIRE(store.getSampleCount() == 0);
+        REQUIRE(store.getBytesInUse() == 0);
+    }
+    REQUIRE(store.getSampleCount() == 0);
+}
+#endif
+
+namespace {
+
+// Bump allocator standing in for the WAMR shared heap
+class TestSampleHeap : public suna::SampleHeap {
+public:
+    uint64_t allocate(size_t bytes, void*& native) override {
+        if (used + bytes > memory.size()) return 0;
+        native = memory.data() + used;
+        const uint64_t offset = BASE + used;
+        used += bytes;
+        ++allocations;
+        return offset;
+    }
+
+    void free(uint64_t appOffset) override {
+        freed.push_back(appOffset);
+    }
+
+    static constexpr uint64_t BASE = 0x1000;
+    std::vector<uint8_t> memory = std::vector<uint8_t>(1 << 20);
+    size_t used = 0;
+    int allocations = 0;
+    std::vector<uint64_t> freed;
+};
+
+} // namespace
+
+TEST_CASE("SampleStore shares equal content and frees with the last slot", "[samplestore]") {
+    suna::SampleStore store;
+    std::vector<float> sample(1000, 0.5f);
+    std::vector<float> other(1000, 0.25f);
+    REQUIRE(store.acquire(sample.data(), static_cast<int>(sample.size())) == nullptr);
+
+    auto heap = std::make_shared<TestSampleHeap>();
+    store.setHeap(heap);
+    auto first = store.acquire(sample.data(), static_cast<int>(sample.size()));
+    auto second = store.acquire(sample.data(), static_cast<int>(sample.size()));
+    auto third = store.acquire(other.data(), static_cast<int>(other.size()));
+    REQUIRE(first != nullptr);
+    REQUIRE(first == second);
+    REQUIRE(first->appOffset == TestSampleHeap::BASE);
+    REQUIRE(first->data[999] == 0.5f);
+    REQUIRE(third != first);
+    REQUIRE(heap->allocations == 2);
+    REQUIRE(store.getSampleCount() == 2);
+    REQUIRE(store.getBytesInUse() == 2 * sample.size() * sizeof(float));
+
+    first.reset();
+    REQUIRE(heap->freed.empty());
+    second.reset();
+    REQUIRE(heap->freed == std::vector<uint64_t>{ TestSampleHeap::BASE });
+    REQUIRE(store.getSampleCount() == 1);
+    REQUIRE(store.getBytesInUse() == other.size() * sizeof(float));
+
+    // An entry outlives a heap change and is freed into its own heap
+    store.setHeap(nullptr);
+    REQUIRE(store.getSampleCount() == 0);
+    REQUIRE(store.acquire(other.data(), static_cast<int>(other.size())) == nullptr);
+    std::weak_ptr<TestSampleHeap> oldHeap = heap;
+    heap.reset();
+    REQUIRE(!oldHeap.expired());
+    third.reset();
+    REQUIRE(oldHeap.expired());
+    REQUIRE(store.getBytesInUse() == 0);
+}
+
+TEST_CASE("WasmDSP granulates the live input", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+    dsp.setPlaybackSpeed(1.0f);
+    dsp.setGrainLength(1000);
+    dsp.setCaptureWindow(0);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.5f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+
+    // No slot plays the input yet
+    REQUIRE(dsp.queueEvent(0, suna::EventType::GrainDensity, 1.0f));
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    REQUIRE(leftOut[numSamples - 1] == 0.0f);
+
+    dsp.setLiveInput(0);
+    REQUIRE(dsp.getLiveInputSlot() == 0);
+    REQUIRE(dsp.getSlotLength(0) == 2 * suna::WasmDSP::CAPTURE_RING_SAMPLES);
+    // Grains start a grain length behind the input, so they sound once
+    // that much has been recorded
+    for (int block = 0; block < 16; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    }
+    REQUIRE(leftOut[numSamples - 1] != 0.0f);
+    REQUIRE(std::isfinite(leftOut[numSamples - 1]));
+
+    // A loaded sample replaces the live input
+    std::vector<float> sample(48000, 0.25f);
+    dsp.loadSample(0, sample.data(), static_cast<int>(sample.size()));
+    REQUIRE(dsp.getLiveInputSlot() == -1);
+    REQUIRE(dsp.getSlotLength(0) == 48000);
+}
+
+TEST_CASE("WasmDSP load meter records every block", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+    for (int block = 0; block < 20; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    }
+
+    auto load = dsp.getLoadMeter().snapshot();
+    REQUIRE(load.blocks == 20);
+    uint64_t histogramTotal = 0;
+    for (auto count : load.histogram) histogramTotal += count;
+    REQUIRE(histogramTotal == 20);
+    REQUIRE(load.peakLoad > 0.0f);
+    REQUIRE(load.maxLoad >= load.peakLoad);
+    // The peak window restarts with every snapshot, the totals do not
+    REQUIRE(dsp.getLoadMeter().snapshot().peakLoad == 0.0f);
+
+    dsp.prepareToPlay(48000.0, 256);
+    REQUIRE(dsp.getLoadMeter().snapshot().blocks == 0);
+}
+
+TEST_CASE("WasmDSP counts dropped and split blocks", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+
+    struct Drops {
+        suna::DropReason reason = suna::DropReason::Count;
+        uint64_t count = 0;
+    } drops;
+    dsp.setDropCallback([](suna::DropReason reason, uint64_t count, void* context) {
+        auto* d = static_cast<Drops*>(context);
+        d->reason = reason;
+        d->count = count;
+    }, &drops);
+
+    constexpr int numSamples = 512;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples, 1.0f), rightOut(numSamples, 1.0f);
+
+    // Before prepareToPlay every block is silence, attributed to NotPrepared
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    REQUIRE(leftOut[0] == 0.0f);
+    REQUIRE(drops.reason == suna::DropReason::NotPrepared);
+    REQUIRE(drops.count == 2);
+
+    dsp.prepareToPlay(48000.0, 256);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 256);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 0);
+
+    const auto stats = dsp.getStats();
+    REQUIRE(stats.blocks == 4);
+    REQUIRE(stats.splitBlocks == 1);
+    REQUIRE(stats.getDropped(suna::DropReason::NotPrepared) == 2);
+    REQUIRE(stats.getTotalDropped() == 2);
+    REQUIRE(drops.count == 2);
+}
+
+TEST_CASE("WasmDSP records trace spans", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+
+    constexpr int numSamples = 256;
+    std::vector<float> in(numSamples, 0.0f);
+    std::vector<float> leftOut(numSamples), rightOut(numSamples);
+    std::vector<float> sample(4800, 0.5f);
+
+    suna::Trace::start();
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    dsp.prepareToPlay(48000.0, numSamples);
+    dsp.loadSample(0, sample.data(), sample.size());
+    for (int block = 0; block < 4; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+    }
+    suna::Trace::stop();
+    // Stopped: nothing more is recorded
+    dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), numSamples);
+
+    const std::string path = "wasm_dsp_test_trace.json";
+    std::string error;
+    REQUIRE(suna::Trace::writeChromeTrace(path, error));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string trace = contents.str();
+    std::remove(path.c_str());
+
+    const auto count = [&](const std::string& needle) {
+        size_t n = 0;
+        for (size_t at = trace.find(needle); at != std::string::npos;
+             at = trace.find(needle, at + 1)) {
+            ++n;
+        }
+        return n;
+    };
+    REQUIRE(trace.rfind("{\"displayTimeUnit\"", 0) == 0);
+    REQUIRE(count("\"name\":\"process_block\"") == 5);
+    REQUIRE(count("\"name\":\"dsp_call\"") == 4);
+    REQUIRE(count("\"name\":\"drop_not_prepared\",\"ph\":\"i\"") == 1);
+    REQUIRE(count("\"name\":\"sample_copy\"") == 1);
+    REQUIRE(count("\"name\":\"loadSample\"") == 1);
+    REQUIRE(count("\"name\":\"audio\"") == 1);
+}
+
+TEST_CASE("Trace reuses the rings of exited threads", "[wasmdsp]") {
+    const auto traceOf = [] {
+        const std::string path = "trace_rings_test.json";
+        std::string error;
+        REQUIRE(suna::Trace::writeChromeTrace(path, error));
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::remove(path.c_str());
+        return contents.str();
+    };
+    const auto recordOn = [](const char* name) {
+        suna::Trace::setThreadName(name);
+        suna::TraceSpan span("ring_test_span");
+    };
+
+    // Far more threads than rings, one after another: each finds a ring
+    suna::Trace::start();
+    for (int i = 0; i < 4 * suna::Trace::MAX_THREADS; ++i) {
+        std::thread(recordOn, i + 1 == 4 * suna::Trace::MAX_THREADS ? "last_thread" : "thread")
+            .join();
+    }
+    suna::Trace::stop();
+    std::string trace = traceOf();
+    REQUIRE(trace.find("\"name\":\"last_thread\"") != std::string::npos);
+    REQUIRE(trace.find("untraced_threads") == std::string::npos);
+
+    // More threads alive at once than rings: the ones left out are counted
+    suna::Trace::start();
+    std::atomic<int> recorded{0};
+    std::atomic<bool> exit{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < suna::Trace::MAX_THREADS + 2; ++i) {
+        threads.emplace_back([&] {
+            suna::Trace::instant("ring_test_instant");
+            recorded.fetch_add(1);
+            while (!exit.load()) std::this_thread::yield();
+        });
+    }
+    while (recorded.load() < suna::Trace::MAX_THREADS + 2) std::this_thread::yield();
+    exit.store(true);
+    for (auto& thread : threads) thread.join();
+    suna::Trace::stop();
+    trace = traceOf();
+    REQUIRE(trace.find("\"name\":\"untraced_threads\"") != std::string::npos);
+}
+
+TEST_CASE("WasmDSP per-function profile", "[wasmdsp]") {
+    suna::WasmDSP dsp;
+    auto aot = loadAOTFile("../../../plugin/resources/suna_dsp.aot");
+    REQUIRE(dsp.initialize(aot.data(), aot.size()));
+    dsp.prepareToPlay(48000.0, 256);
+
+    std::vector<float> in(256, 0.0f);
+    std::vector<float> leftOut(256), rightOut(256);
+    for (int block = 0; block < 8; ++block) {
+        dsp.processBlock(in.data(), in.data(), leftOut.data(), rightOut.data(), 256);
+    }
+
+    std::vector<suna::FunctionProfile> functions;
+#if SUNA_WASM_PROFILING
+    REQUIRE(dsp.getProfile(functions));
+    REQUIRE(!functions.empty());
+    for (size_t i = 1; i < functions.size(); ++i) {
+        REQUIRE(functions[i - 1].selfMs >= functions[i].selfMs);
+    }
+#else
+    // Only a profiling build can time the module's functions
+    REQUIRE_FALSE(dsp.getProfile(functions));
+    REQUIRE(functions.empty());
+#endif
+}
+
+TEST_CASE("DspLoadMeter buckets load by block duration", "[wasmdsp]") {
+    suna::DspLoadMeter meter;
+    meter.record(0.001, 0.010);   // 10%
+    meter.record(0.0085, 0.010);  // 85%: near an xrun
+    meter.record(0.012, 0.010);   // 120%: over budget
+    meter.record(0.001, 0.0);     // no duration: ignored
+
+    const auto load = meter.snapshot();
+    REQUIRE(load.blocks == 3);
+    REQUIRE(load.histogram[1] == 1);
+    REQUIRE(load.histogram[8] == 1);
+    REQUIRE(load.histogram[suna::DspLoadMeter::BUCKET_COUNT - 1] == 1);
+    REQUIRE(load.xrunRisk == 2);
+    REQUIRE(load.overruns == 1);
+    REQUIRE(load.lastLoad == Catch::Approx(1.2f));
+    REQUIRE(load.peakLoad == Catch::Approx(1.2f));
+    REQUIRE(load.maxLoad == Catch::Approx(1.2f));
+}
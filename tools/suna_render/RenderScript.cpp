@@ -0,0 +1,266 @@
+#include "RenderScript.h"
+#include "WavFile.h"
+#include "suna/WasmDSP.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace suna {
+
+namespace {
+
+struct CommandSpec {
+    const char* name;
+    int numArgs;
+    bool isEvent;
+    EventType type;
+};
+
+const CommandSpec COMMANDS[] = {
+    { "blend_x",       1, true,  EventType::BlendX },
+    { "blend_y",       1, true,  EventType::BlendY },
+    { "speed",         1, true,  EventType::PlaybackSpeed },
+    { "speed_target",  1, true,  EventType::SpeedTarget },
+    { "grain_length",  1, true,  EventType::GrainLength },
+    { "density",       1, true,  EventType::GrainDensity },
+    { "freeze",        1, true,  EventType::Freeze },
+    { "interpolation", 1, true,  EventType::Interpolation },
+    { "jitter",        1, true,  EventType::GrainJitter },
+    { "max_overlap",   1, true,  EventType::MaxOverlap },
+    { "play",          0, true,  EventType::PlayAll },
+    { "stop",          0, true,  EventType::StopAll },
+    { "note_on",       2, true,  EventType::NoteOn },
+    { "note_off",      1, true,  EventType::NoteOff },
+    { "all_notes_off", 0, true,  EventType::AllNotesOff },
+    { "load",          2, false, EventType::BlendX },
+    { "clear",         1, false, EventType::BlendX },
+    { "live_input",    1, false, EventType::BlendX },
+    { "end",           0, false, EventType::BlendX },
+};
+
+const CommandSpec* findCommand(const std::string& name) {
+    for (const auto& spec : COMMANDS) {
+        if (name == spec.name) return &spec;
+    }
+    return nullptr;
+}
+
+bool parseTime(const std::string& text, double sampleRate, int64_t& sample) {
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0.0) return false;
+    const std::string unit(end);
+    if (unit.empty() || unit == "s") {
+        sample = static_cast<int64_t>(std::llround(value * sampleRate));
+    } else if (unit == "ms") {
+        sample = static_cast<int64_t>(std::llround(value * sampleRate / 1000.0));
+    } else if (unit == "smp") {
+        sample = static_cast<int64_t>(value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool isNumber(const std::string& text) {
+    char* end = nullptr;
+    std::strtod(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0';
+}
+
+std::string resolvePath(const std::string& baseDir, const std::string& path) {
+    if (baseDir.empty() || path.empty() || path[0] == '/') return path;
+    return baseDir + "/" + path;
+}
+
+bool applyHostCommand(WasmDSP& dsp, const RenderCommand& command,
+                      const RenderOptions& options, std::string& error) {
+    const int slot = std::atoi(command.args.empty() ? "0" : command.args[0].c_str());
+    if (command.name == "load") {
+        WavFile wav;
+        if (!WavFile::read(resolvePath(options.baseDir, command.args[1]), wav, error)) {
+            error = "line " + std::to_string(command.line) + ": " + error;
+            return false;
+        }
+        const auto mono = wav.mixToMono();
+        if (mono.empty()) {
+            error = "line " + std::to_string(command.line) + ": " + command.args[1] + " is empty";
+            return false;
+        }
+        dsp.loadSample(slot, mono.data(), static_cast<int>(mono.size()));
+    } else if (command.name == "clear") {
+        dsp.clearSlot(slot);
+    } else if (command.name == "live_input") {
+        dsp.setLiveInput(slot);
+    }
+    return true;
+}
+
+} // namespace
+
+bool RenderScript::parse(const std::string& text, double sampleRate,
+                         RenderScript& script, std::string& error) {
+    script = RenderScript();
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string time;
+        if (!(words >> time)) continue;
+
+        RenderCommand command;
+        command.line = lineNumber;
+        if (!parseTime(time, sampleRate, command.sample)) {
+            error = "line " + std::to_string(lineNumber) + ": bad time '" + time + "'";
+            return false;
+        }
+        if (!(words >> command.name)) {
+            error = "line " + std::to_string(lineNumber) + ": missing command";
+            return false;
+        }
+        for (std::string arg; words >> arg;) {
+            command.args.push_back(arg);
+        }
+
+        const CommandSpec* spec = findCommand(command.name);
+        if (!spec) {
+            error = "line " + std::to_string(lineNumber) + ": unknown command '" + command.name + "'";
+            return false;
+        }
+        if (static_cast<int>(command.args.size()) != spec->numArgs) {
+            error = "line " + std::to_string(lineNumber) + ": " + command.name + " takes " +
+                    std::to_string(spec->numArgs) + " argument(s)";
+            return false;
+        }
+        // Every argument is numeric except the file of `load`
+        for (size_t i = 0; i < command.args.size(); ++i) {
+            const bool isPath = command.name == "load" && i == 1;
+            if (!isPath && !isNumber(command.args[i])) {
+                error = "line " + std::to_string(lineNumber) + ": '" + command.args[i] +
+                        "' is not a number";
+                return false;
+            }
+        }
+
+        if (command.name == "end") {
+            script.endSample = command.sample;
+        } else {
+            script.commands.push_back(command);
+        }
+    }
+    // Commands at the same time keep their order in the file
+    std::stable_sort(script.commands.begin(), script.commands.end(),
+                     [](const RenderCommand& a, const RenderCommand& b) { return a.sample < b.sample; });
+    return true;
+}
+
+bool RenderScript::load(const std::string& path, double sampleRate,
+                        RenderScript& script, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    if (!parse(buffer.str(), sampleRate, script, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool renderScript(const std::vector<uint8_t>& aot, const RenderScript& script,
+                  const RenderOptions& options, RenderResult& result) {
+    using Clock = std::chrono::steady_clock;
+    result = RenderResult();
+    const auto setupStart = Clock::now();
+
+    WasmDSP dsp;
+    if (!dsp.initialize(aot.data(), aot.size(), options.renderThreads, options.backend)) {
+        result.error = "WasmDSP initialization failed";
+        return false;
+    }
+    dsp.setNonRealtime(options.nonRealtime);
+    dsp.prepareToPlay(options.sampleRate, options.blockSize);
+    for (const auto& [slot, sample] : options.slots) {
+        dsp.loadSample(slot, sample.data(), static_cast<int>(sample.size()));
+    }
+    result.setupMs = std::chrono::duration<double, std::milli>(Clock::now() - setupStart).count();
+
+    const int64_t length = script.endSample >= 0 ? script.endSample : options.lengthSamples;
+    const int blockSize = options.blockSize;
+    result.left.assign(static_cast<size_t>(length), 0.0f);
+    result.right.assign(static_cast<size_t>(length), 0.0f);
+    result.blockNs.reserve(static_cast<size_t>((length + blockSize - 1) / blockSize));
+
+    std::vector<float> inLeft(static_cast<size_t>(blockSize));
+    std::vector<float> inRight(static_cast<size_t>(blockSize));
+    size_t next = 0;
+
+    for (int64_t blockStart = 0; blockStart < length; blockStart += blockSize) {
+        const int numSamples = static_cast<int>(std::min<int64_t>(blockSize, length - blockStart));
+        const int64_t blockEnd = blockStart + numSamples;
+
+        for (; next < script.commands.size() && script.commands[next].sample < blockEnd; ++next) {
+            const auto& command = script.commands[next];
+            const CommandSpec* spec = findCommand(command.name);
+            if (!spec->isEvent) {
+                if (!applyHostCommand(dsp, command, options, result.error)) {
+                    dsp.shutdown();
+                    return false;
+                }
+                continue;
+            }
+            const int offset = static_cast<int>(std::max<int64_t>(0, command.sample - blockStart));
+            float value = 0.0f;
+            int data = 0;
+            if (spec->type == EventType::NoteOn) {
+                data = std::atoi(command.args[0].c_str());
+                value = static_cast<float>(std::atof(command.args[1].c_str()));
+            } else if (spec->type == EventType::NoteOff) {
+                data = std::atoi(command.args[0].c_str());
+            } else if (!command.args.empty()) {
+                value = static_cast<float>(std::atof(command.args[0].c_str()));
+            }
+            if (!dsp.queueEvent(offset, spec->type, value, data)) {
+                result.error = "line " + std::to_string(command.line) + ": block event list full";
+                dsp.shutdown();
+                return false;
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            const size_t index = static_cast<size_t>(blockStart + i);
+            inLeft[i] = index < options.inputLeft.size() ? options.inputLeft[index] : 0.0f;
+            inRight[i] = index < options.inputRight.size() ? options.inputRight[index] : inLeft[i];
+        }
+
+        const auto start = Clock::now();
+        dsp.processBlock(inLeft.data(), inRight.data(),
+                         result.left.data() + blockStart, result.right.data() + blockStart,
+                         numSamples);
+        result.blockNs.push_back(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+    }
+
+    const auto stats = dsp.getStats();
+    result.droppedBlocks = stats.getTotalDropped();
+    result.lateWorkerShares = stats.lateWorkerShares;
+    if (options.profile && !dsp.getProfile(result.profile)) {
+        result.error = "no per-function profile: needs a SUNA_WASM_PROFILING build "
+                       "and the wamr backend";
+        dsp.shutdown();
+        return false;
+    }
+    dsp.shutdown();
+    return true;
+}
+
+} // namespace suna
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "suna/DspBackend.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace suna {
+
+/** One timed line of a render script */
+struct RenderCommand {
+    int64_t sample = 0;              // when it applies, from the start of the render
+    std::string name;
+    std::vector<std::string> args;
+    int line = 0;
+};
+
+/**
+ * RenderScript - timed parameter and command list for offline renders
+ *
+ * One command per line: `<time> <command> [args...]`, `#` starts a comment.
+ * Times are seconds (`1.5`), milliseconds (`250ms`) or samples (`4800smp`).
+ *
+ * Commands applied on their exact sample (as WasmDSP events):
+ *   blend_x V, blend_y V, speed V, speed_target V, grain_length SAMPLES,
+ *   density V, freeze 0|1, interpolation MODE, jitter V, max_overlap N,
+ *   play, stop, note_on NOTE VELOCITY, note_off NOTE, all_notes_off
+ * Commands applied before the block containing their time:
+ *   load SLOT FILE.wav, clear SLOT, live_input SLOT
+ * And `end` sets the render length.
+ */
+struct RenderScript {
+    std::vector<RenderCommand> commands;   // sorted by sample
+    int64_t endSample = -1;                // from `end` (-1 = not given)
+
+    /** @return false (with a message naming the line in error) on bad input */
+    static bool parse(const std::string& text, double sampleRate,
+                      RenderScript& script, std::string& error);
+    static bool load(const std::string& path, double sampleRate,
+                     RenderScript& script, std::string& error);
+};
+
+struct RenderOptions {
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int64_t lengthSamples = 48000 * 10;    // used when the script has no `end`
+    int renderThreads = 1;
+    DspBackendType backend = DspBackendType::WamrAot;
+    bool nonRealtime = false;
+    bool profile = false;                  // fill RenderResult::profile
+    std::string baseDir;                   // relative `load` paths start here
+    std::map<int, std::vector<float>> slots;  // loaded before the first block
+    std::vector<float> inputLeft;          // plugin input (live input slots)
+    std::vector<float> inputRight;
+};
+
+struct RenderResult {
+    std::vector<float> left;
+    std::vector<float> right;
+    std::vector<double> blockNs;           // processBlock time of every block
+    double setupMs = 0.0;                  // initialize, prepare and initial loads
+    uint64_t droppedBlocks = 0;            // blocks WasmDSP output as silence
+    uint64_t lateWorkerShares = 0;         // worker shares rendered by the audio thread
+    std::vector<FunctionProfile> profile;  // hottest first (options.profile)
+    std::string error;
+};
+
+/**
+ * Render a script through a fresh WasmDSP instance (aot is unused by the
+ * native backend)
+ * @return false (with result.error set) if the DSP or a command fails
+ */
+bool renderScript(const std::vector<uint8_t>& aot, const RenderScript& script,
+                  const RenderOptions& options, RenderResult& result);
+
+} // namespace suna
@@ -0,0 +1,164 @@
+#include "WavFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace suna {
+
+namespace {
+
+constexpr uint16_t FORMAT_PCM = 1;
+constexpr uint16_t FORMAT_FLOAT = 3;
+constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void writeU32(std::ofstream& out, uint32_t value) {
+    const uint8_t bytes[4] = { static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+                               static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24) };
+    out.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+void writeU16(std::ofstream& out, uint16_t value) {
+    const uint8_t bytes[2] = { static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8) };
+    out.write(reinterpret_cast<const char*>(bytes), 2);
+}
+
+float decodeSample(const uint8_t* p, uint16_t format, uint16_t bits) {
+    if (format == FORMAT_FLOAT) {
+        float value;
+        const uint32_t raw = readU32(p);
+        std::memcpy(&value, &raw, sizeof(value));
+        return value;
+    }
+    switch (bits) {
+        case 16:
+            return static_cast<float>(static_cast<int16_t>(readU16(p))) / 32768.0f;
+        case 24: {
+            int32_t value = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+            if (value & 0x800000) value -= 0x1000000;
+            return static_cast<float>(value) / 8388608.0f;
+        }
+        default:
+            return static_cast<float>(static_cast<int32_t>(readU32(p))) / 2147483648.0f;
+    }
+}
+
+} // namespace
+
+std::vector<float> WavFile::mixToMono() const {
+    std::vector<float> mono(static_cast<size_t>(getNumSamples()), 0.0f);
+    if (channels.empty()) return mono;
+    const float scale = 1.0f / static_cast<float>(channels.size());
+    for (const auto& channel : channels) {
+        for (size_t i = 0; i < mono.size(); ++i) {
+            mono[i] += channel[i] * scale;
+        }
+    }
+    return mono;
+}
+
+bool WavFile::read(const std::string& path, WavFile& wav, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+        std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        error = path + " is not a RIFF/WAVE file";
+        return false;
+    }
+
+    uint16_t format = 0, numChannels = 0, bits = 0;
+    uint32_t sampleRate = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcmBytes = 0;
+    for (size_t pos = 12; pos + 8 <= data.size();) {
+        const uint8_t* chunk = data.data() + pos;
+        const size_t size = readU32(chunk + 4);
+        const size_t available = std::min(size, data.size() - pos - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = readU16(chunk + 8);
+            numChannels = readU16(chunk + 10);
+            sampleRate = readU32(chunk + 12);
+            bits = readU16(chunk + 22);
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format in its sub-format GUID
+            if (format == FORMAT_EXTENSIBLE && available >= 26) {
+                format = readU16(chunk + 32);
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            pcmBytes = available;
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    const bool supported = numChannels > 0 &&
+        ((format == FORMAT_PCM && (bits == 16 || bits == 24 || bits == 32)) ||
+         (format == FORMAT_FLOAT && bits == 32));
+    if (!supported || !pcm) {
+        error = path + ": only 16/24/32-bit PCM and 32-bit float WAV files are supported";
+        return false;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(numChannels) * (bits / 8);
+    const size_t frames = pcmBytes / frameBytes;
+    wav.sampleRate = static_cast<double>(sampleRate);
+    wav.channels.assign(numChannels, std::vector<float>(frames));
+    for (size_t i = 0; i < frames; ++i) {
+        for (uint16_t ch = 0; ch < numChannels; ++ch) {
+            wav.channels[ch][i] = decodeSample(pcm + i * frameBytes + ch * (bits / 8), format, bits);
+        }
+    }
+    return true;
+}
+
+bool WavFile::write(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    const uint16_t numChannels = static_cast<uint16_t>(channels.size());
+    const uint32_t frames = static_cast<uint32_t>(getNumSamples());
+    const uint32_t dataBytes = frames * numChannels * sizeof(float);
+
+    out.write("RIFF", 4);
+    writeU32(out, 36 + dataBytes);
+    out.write("WAVE", 4);
+    out.write("fmt ", 4);
+    writeU32(out, 16);
+    writeU16(out, FORMAT_FLOAT);
+    writeU16(out, numChannels);
+    writeU32(out, static_cast<uint32_t>(sampleRate));
+    writeU32(out, static_cast<uint32_t>(sampleRate) * numChannels * sizeof(float));
+    writeU16(out, static_cast<uint16_t>(numChannels * sizeof(float)));
+    writeU16(out, 32);
+    out.write("data", 4);
+    writeU32(out, dataBytes);
+    for (uint32_t i = 0; i < frames; ++i) {
+        for (const auto& channel : channels) {
+            uint32_t raw;
+            std::memcpy(&raw, &channel[i], sizeof(raw));
+            writeU32(out, raw);
+        }
+    }
+    if (!out) {
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace suna
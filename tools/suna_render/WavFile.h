@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace suna {
+
+/** Audio read from or written to a RIFF/WAVE file, deinterleaved */
+struct WavFile {
+    double sampleRate = 48000.0;
+    std::vector<std::vector<float>> channels;
+
+    int getNumSamples() const {
+        return channels.empty() ? 0 : static_cast<int>(channels[0].size());
+    }
+
+    /** Average of all channels (slots hold mono samples) */
+    std::vector<float> mixToMono() const;
+
+    /**
+     * Read 16/24/32-bit PCM or 32-bit float data
+     * @return false (with a message in error) on unsupported or broken files
+     */
+    static bool read(const std::string& path, WavFile& wav, std::string& error);
+
+    /** Write as 32-bit float, so renders round-trip bit-exactly */
+    bool write(const std::string& path, std::string& error) const;
+};
+
+} // namespace suna
@@ -0,0 +1,248 @@
+// suna_render - headless, deterministic render of the DSP through WasmDSP
+//
+// Loads the AOT module and WAV files into slots, applies a timed command
+// script (see RenderScript.h) and writes the output as a 32-bit float WAV
+// plus a timing report. The same inputs always give the same output, so
+// renders can be profiled (perf, callgrind) and compared across changes.
+//
+// Usage:
+//   suna_render --aot suna_dsp.aot --script pad.txt --out pad.wav
+//               [--slot N=FILE.wav]... [--input FILE.wav] [--seconds S]
+//               [--sample-rate HZ] [--block N] [--threads N] [--offline]
+//               [--backend wamr|native] [--report FILE.json] [--trace FILE.json]
+//               [--profile]
+//
+// --backend native renders with NativeDSP (no AOT module needed), for
+// comparing its output and speed with the WAMR build of the same DSP.
+// --trace records the render's spans (blocks, lock waits, worker barriers)
+// as a Chrome trace for Perfetto.
+// --profile prints the DSP functions ranked by self time (needs a
+// SUNA_WASM_PROFILING build, see the top-level CMakeLists.txt).
+
+#include "RenderScript.h"
+#include "WavFile.h"
+#include "suna/Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s --aot FILE --out FILE.wav [--script FILE] [--slot N=FILE.wav]...\n"
+        "          [--input FILE.wav] [--seconds S] [--sample-rate HZ] [--block N]\n"
+        "          [--threads N] [--offline] [--backend wamr|native] [--report FILE.json]\n"
+        "          [--trace FILE.json] [--profile]\n",
+        program);
+}
+
+static std::vector<uint8_t> readBinary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+    auto size = file.tellg();
+    file.seekg(0);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+static std::string directoryOf(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+// Ranked table on stderr, so the report can stay on stdout
+static void printProfile(const std::vector<suna::FunctionProfile>& functions) {
+    double totalSelfMs = 0.0;
+    for (const auto& function : functions) totalSelfMs += function.selfMs;
+    std::fprintf(stderr, "%10s %7s %10s %12s  %s\n", "self ms", "self %", "total ms", "calls", "function");
+    for (const auto& function : functions) {
+        if (function.calls == 0) continue;
+        std::fprintf(stderr, "%10.3f %6.1f%% %10.3f %12llu  %s\n",
+                     function.selfMs, totalSelfMs > 0.0 ? 100.0 * function.selfMs / totalSelfMs : 0.0,
+                     function.totalMs, static_cast<unsigned long long>(function.calls),
+                     function.name.c_str());
+    }
+}
+
+static std::string timingReport(const suna::RenderOptions& options,
+                                const suna::RenderResult& result) {
+    std::vector<double> sorted = result.blockNs;
+    std::sort(sorted.begin(), sorted.end());
+    double totalNs = 0.0;
+    for (double ns : sorted) totalNs += ns;
+    auto percentile = [&](double p) {
+        if (sorted.empty()) return 0.0;
+        return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)] / 1000.0;
+    };
+    const double samples = static_cast<double>(result.left.size());
+    const double audioSeconds = samples / options.sampleRate;
+
+    char report[1024];
+    std::snprintf(report, sizeof(report),
+        "{\n"
+        "  \"sample_rate\": %.0f,\n"
+        "  \"block_size\": %d,\n"
+        "  \"render_threads\": %d,\n"
+        "  \"backend\": \"%s\",\n"
+        "  \"non_realtime\": %s,\n"
+        "  \"samples\": %.0f,\n"
+        "  \"blocks\": %zu,\n"
+        "  \"dropped_blocks\": %llu,\n"
+        "  \"late_worker_shares\": %llu,\n"
+        "  \"setup_ms\": %.3f,\n"
+        "  \"process_ms\": %.3f,\n"
+        "  \"ns_per_sample\": %.3f,\n"
+        "  \"realtime_factor\": %.2f,\n"
+        "  \"p50_us\": %.3f,\n"
+        "  \"p99_us\": %.3f,\n"
+        "  \"max_us\": %.3f,\n"
+        "  \"budget_us\": %.3f\n"
+        "}\n",
+        options.sampleRate, options.blockSize, options.renderThreads,
+        suna::getBackendName(options.backend), options.nonRealtime ? "true" : "false",
+        samples, sorted.size(), static_cast<unsigned long long>(result.droppedBlocks),
+        static_cast<unsigned long long>(result.lateWorkerShares),
+        result.setupMs, totalNs / 1e6,
+        samples > 0.0 ? totalNs / samples : 0.0,
+        totalNs > 0.0 ? audioSeconds * 1e9 / totalNs : 0.0,
+        percentile(0.50), percentile(0.99), sorted.empty() ? 0.0 : sorted.back() / 1000.0,
+        options.blockSize * 1e6 / options.sampleRate);
+    return report;
+}
+
+int main(int argc, char** argv) {
+    std::string aotPath, scriptPath, outPath, inputPath, reportPath, tracePath;
+    std::vector<std::pair<int, std::string>> slotFiles;
+    double seconds = 10.0;
+    suna::RenderOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--aot" && hasValue) {
+            aotPath = argv[++i];
+        } else if (arg == "--script" && hasValue) {
+            scriptPath = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else if (arg == "--input" && hasValue) {
+            inputPath = argv[++i];
+        } else if (arg == "--report" && hasValue) {
+            reportPath = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            tracePath = argv[++i];
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--sample-rate" && hasValue) {
+            options.sampleRate = std::atof(argv[++i]);
+        } else if (arg == "--block" && hasValue) {
+            options.blockSize = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.renderThreads = std::atoi(argv[++i]);
+        } else if (arg == "--backend" && hasValue) {
+            if (!suna::parseBackendName(argv[++i], options.backend)) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--offline") {
+            options.nonRealtime = true;
+        } else if (arg == "--slot" && hasValue) {
+            const std::string spec = argv[++i];
+            const size_t eq = spec.find('=');
+            if (eq == std::string::npos) {
+                printUsage(argv[0]);
+                return 2;
+            }
+            slotFiles.emplace_back(std::atoi(spec.substr(0, eq).c_str()), spec.substr(eq + 1));
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    const bool native = options.backend == suna::DspBackendType::Native;
+    if ((aotPath.empty() && !native) || outPath.empty() || options.blockSize <= 0 ||
+        options.sampleRate <= 0.0 || seconds < 0.0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    options.lengthSamples = static_cast<int64_t>(seconds * options.sampleRate);
+
+    const auto aot = aotPath.empty() ? std::vector<uint8_t>() : readBinary(aotPath);
+    if (aot.empty() && !native) {
+        std::fprintf(stderr, "suna_render: cannot read %s\n", aotPath.c_str());
+        return 1;
+    }
+
+    std::string error;
+    suna::RenderScript script;
+    if (!scriptPath.empty()) {
+        if (!suna::RenderScript::load(scriptPath, options.sampleRate, script, error)) {
+            std::fprintf(stderr, "suna_render: %s\n", error.c_str());
+            return 1;
+        }
+        options.baseDir = directoryOf(scriptPath);
+    }
+
+    for (const auto& [slot, path] : slotFiles) {
+        suna::WavFile wav;
+        if (!suna::WavFile::read(path, wav, error)) {
+            std::fprintf(stderr, "suna_render: %s\n", error.c_str());
+            return 1;
+        }
+        if (wav.sampleRate != options.sampleRate) {
+            std::fprintf(stderr, "suna_render: warning: %s is %.0f Hz, rendering at %.0f Hz\n",
+                         path.c_str(), wav.sampleRate, options.sampleRate);
+        }
+        options.slots[slot] = wav.mixToMono();
+    }
+    if (!inputPath.empty()) {
+        suna::WavFile wav;
+        if (!suna::WavFile::read(inputPath, wav, error)) {
+            std::fprintf(stderr, "suna_render: %s\n", error.c_str());
+            return 1;
+        }
+        options.inputLeft = wav.channels[0];
+        options.inputRight = wav.channels.size() > 1 ? wav.channels[1] : wav.channels[0];
+    }
+
+    if (!tracePath.empty()) {
+        suna::Trace::start();
+    }
+    suna::RenderResult result;
+    if (!suna::renderScript(aot, script, options, result)) {
+        std::fprintf(stderr, "suna_render: %s\n", result.error.c_str());
+        return 1;
+    }
+    if (!tracePath.empty()) {
+        suna::Trace::stop();
+        if (!suna::Trace::writeChromeTrace(tracePath, error)) {
+            std::fprintf(stderr, "suna_render: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    const auto report = timingReport(options, result);
+    if (options.profile) {
+        printProfile(result.profile);
+    }
+
+    suna::WavFile out;
+    out.sampleRate = options.sampleRate;
+    out.channels = { std::move(result.left), std::move(result.right) };
+    if (!out.write(outPath, error)) {
+        std::fprintf(stderr, "suna_render: %s\n", error.c_str());
+        return 1;
+    }
+    if (reportPath.empty()) {
+        std::fputs(report.c_str(), stdout);
+    } else {
+        std::ofstream(reportPath) << report;
+    }
+    return 0;
+}
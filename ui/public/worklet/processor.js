@@ -1,3 +1,6 @@
+// Grains in the DSP's pool (100-2000, fixed after init_sampler)
+const GRAIN_POOL_SIZE = 100;
+
 class SunaProcessor extends AudioWorkletProcessor {
   constructor() {
     super();
@@ -39,6 +42,12 @@ class SunaProcessor extends AudioWorkletProcessor {
         this.handleSetFreeze(event.data.freeze);
       } else if (type === 'setSpeedTarget') {
         this.handleSetSpeedTarget(event.data.target);
+      } else if (type === 'setInterpolation') {
+        this.handleSetInterpolation(event.data.mode);
+      } else if (type === 'setGrainJitter') {
+        this.handleSetGrainJitter(event.data.amount);
+      } else if (type === 'setMaxOverlap') {
+        this.handleSetMaxOverlap(event.data.count);
       }
     };
   }
@@ -64,7 +73,8 @@ class SunaProcessor extends AudioWorkletProcessor {
       const instance = await WebAssembly.instantiate(wasmModule, importObject);
       this.wasm = instance.exports;
 
-      this.wasm.init_sampler(sampleRate);
+      // The grain pool is sized once, here
+      this.wasm.init_sampler(sampleRate, GRAIN_POOL_SIZE);
 
       const BLOCK_SIZE = 128;
       const BYTES_PER_FLOAT = 4;
@@ -150,6 +160,21 @@ class SunaProcessor extends AudioWorkletProcessor {
     this.wasm.set_speed_target(target);
   }
 
+  handleSetInterpolation(mode) {
+    if (!this.wasm) return;
+    this.wasm.set_interpolation(mode);
+  }
+
+  handleSetGrainJitter(amount) {
+    if (!this.wasm) return;
+    this.wasm.set_grain_jitter(amount);
+  }
+
+  handleSetMaxOverlap(count) {
+    if (!this.wasm) return;
+    this.wasm.set_max_overlap(count);
+  }
+
   process(inputs, outputs) {
     if (!this.initialized || !this.wasm) return true;
 
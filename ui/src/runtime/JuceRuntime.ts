@@ -1,4 +1,4 @@
-import type { AudioRuntime, ParameterState } from './types'
+import type { AudioRuntime, DspLoadSnapshot, InterpolationMode, ParameterState } from './types'
 import { getSliderState, getNativeFunction } from '../juce/index.js'
 
 function encodeFloat32ToBase64(float32Array: Float32Array): string {
@@ -105,4 +105,28 @@ export class JuceRuntime implements AudioRuntime {
     if (typeof window === 'undefined' || !window.__JUCE__) return
     getNativeFunction('setSpeedTarget')(target)
   }
+
+  setInterpolation(mode: InterpolationMode): void {
+    if (typeof window === 'undefined' || !window.__JUCE__) return
+    getNativeFunction('setInterpolation')(mode)
+  }
+
+  setGrainJitter(amount: number): void {
+    if (typeof window === 'undefined' || !window.__JUCE__) return
+    getNativeFunction('setGrainJitter')(amount)
+  }
+
+  setMaxOverlap(count: number): void {
+    if (typeof window === 'undefined' || !window.__JUCE__) return
+    getNativeFunction('setMaxOverlap')(count)
+  }
+
+  onDspLoad(callback: (snapshot: DspLoadSnapshot) => void): () => void {
+    if (typeof window === 'undefined' || !window.__JUCE__) return () => {}
+    const backend = window.__JUCE__.backend
+    const registration = backend.addEventListener('dspLoad', (data) => {
+      callback(data as DspLoadSnapshot)
+    })
+    return () => backend.removeEventListener(registration)
+  }
 }
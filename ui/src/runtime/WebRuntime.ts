@@ -1,4 +1,4 @@
-import type { AudioRuntime, ParameterState, ParameterProperties } from './types';
+import type { AudioRuntime, InterpolationMode, ParameterState, ParameterProperties } from './types';
 
 export class WebRuntime implements AudioRuntime {
   readonly type = 'web' as const
@@ -89,6 +89,18 @@ export class WebRuntime implements AudioRuntime {
     this.workletNode?.port.postMessage({ type: 'setSpeedTarget', target });
   }
 
+  setInterpolation(mode: InterpolationMode): void {
+    this.workletNode?.port.postMessage({ type: 'setInterpolation', mode });
+  }
+
+  setGrainJitter(amount: number): void {
+    this.workletNode?.port.postMessage({ type: 'setGrainJitter', amount });
+  }
+
+  setMaxOverlap(count: number): void {
+    this.workletNode?.port.postMessage({ type: 'setMaxOverlap', count });
+  }
+
    getParameter(id: string): ParameterState | null {
      const config = this.parameterConfigs[id];
      if (!config) return null;
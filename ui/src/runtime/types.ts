@@ -20,6 +20,24 @@ export interface ParameterState {
   sliderDragEnded?(): void
 }
 
+/** processBlock time as a fraction of the block duration (1 = the whole deadline) */
+export interface DspLoadSnapshot {
+  load: number
+  average: number
+  peak: number          // highest since the previous snapshot
+  max: number           // highest since prepareToPlay
+  blocks: number
+  xrunRisk: number      // blocks at 80% load or more
+  overruns: number      // blocks over 100%
+  histogram: number[]   // block counts per 10% of load, the last bucket is >= 100%
+  droppedTotal: number  // blocks output as silence
+  dropped: Record<'thread_env_init' | 'not_prepared' | 'lock_contention' |
+    'memory_unavailable' | 'wasm_exception' | 'worker_exception', number>
+}
+
+/** Grain sample reader: 0 nearest, 1 linear, 2 cubic Hermite, 3 windowed sinc */
+export type InterpolationMode = 0 | 1 | 2 | 3
+
 export interface AudioRuntime {
   readonly type: 'juce' | 'web'
   getParameter(id: string): ParameterState | null
@@ -36,4 +54,8 @@ export interface AudioRuntime {
   setGrainDensity?(density: number): void
   setFreeze?(freeze: boolean): void
   setSpeedTarget?(target: number): void
+  setInterpolation?(mode: InterpolationMode): void
+  setGrainJitter?(amount: number): void
+  setMaxOverlap?(count: number): void
+  onDspLoad?(callback: (snapshot: DspLoadSnapshot) => void): () => void
 }
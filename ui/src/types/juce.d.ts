@@ -23,7 +23,8 @@ interface ToggleState {
 }
 
 interface Backend {
-  addEventListener(eventId: string, callback: (data: unknown) => void): () => void
+  addEventListener(eventId: string, callback: (data: unknown) => void): [string, number]
+  removeEventListener(registration: [string, number]): void
   emitEvent(eventId: string, data: unknown): void
 }
 